@@ -31,6 +31,75 @@
 #include "Filter.h"
 #include <stdio.h>
 
+// Loads order+1 coefficients into the numerator and denominator ring buffers.
+static void filter_load_coeffs( Ring_Buffer_Float_t* p_num, Ring_Buffer_Float_t* p_den, float* numerator_coeffs, float* denominator_coeffs,
+                                uint8_t order )
+{
+    rb_initialize_F( p_num );
+    rb_initialize_F( p_den );
+
+    // num coefficents = order + 1
+    for( uint8_t i = 0; i <= order; i++ ) {
+        rb_push_back_F( p_num, numerator_coeffs[i] );
+        rb_push_back_F( p_den, denominator_coeffs[i] );
+    }
+}
+
+// Resets the input and output history to length zeros.
+static void filter_zero_history( Ring_Buffer_Float_t* p_in, Ring_Buffer_Float_t* p_out, uint8_t length )
+{
+    rb_initialize_F( p_in );
+    rb_initialize_F( p_out );
+
+    for( uint8_t i = 0; i < length; i++ ) {
+        rb_push_back_F( p_in, 0 );
+        rb_push_back_F( p_out, 0 );
+    }
+}
+
+// Shifts a new input into the history, dropping the oldest input and output. Afterwards x_n is at index length-1 of
+// in_list and y_n-1 at index length-2 of out_list.
+static void filter_shift_in( Ring_Buffer_Float_t* p_in, Ring_Buffer_Float_t* p_out, float value )
+{
+    rb_pop_front_F( p_in );
+    rb_pop_front_F( p_out );
+    rb_push_back_F( p_in, value );
+}
+
+// Evaluates the difference equation over shifted history without modifying anything. The coefficients are only read,
+// so the same set can be used by any number of histories.
+static float filter_eval( const Ring_Buffer_Float_t* p_num, const Ring_Buffer_Float_t* p_den, const Ring_Buffer_Float_t* p_in,
+                          const Ring_Buffer_Float_t* p_out )
+{
+    uint8_t length = rb_length_F( p_num );
+
+    float in_sum  = 0;
+    float out_sum = 0;
+
+    // SUM( B_i * x_n-i ), i=0..N
+    for( uint8_t i = 0; i < length; i++ )
+        in_sum += rb_get_F( p_num, i ) * rb_get_F( p_in, length - 1 - i );
+
+    // SUM( A_i * y_n-i ), i=1..N
+    for( uint8_t i = 1; i < length; i++ )
+        out_sum += rb_get_F( p_den, i ) * rb_get_F( p_out, length - 1 - i );
+
+    return ( in_sum - out_sum ) / rb_get_F( p_den, 0 );
+}
+
+// Steps the difference equation once.
+static float filter_step( const Ring_Buffer_Float_t* p_num, const Ring_Buffer_Float_t* p_den, Ring_Buffer_Float_t* p_in, Ring_Buffer_Float_t* p_out,
+                          float value )
+{
+    filter_shift_in( p_in, p_out, value );
+
+    float out_val = filter_eval( p_num, p_den, p_in, p_out );
+
+    rb_push_back_F( p_out, out_val );
+
+    return out_val;
+}
+
 /**
  * Function Filter_Init initializes the filter given two float arrays and the order of the filter.  Note that the
  * size of the array will be one larger than the order. (First order systems have two coefficients).
@@ -50,21 +119,9 @@
  */
 void Filter_Init( Filter_Data_t* p_filt, float* numerator_coeffs, float* denominator_coeffs, uint8_t order )
 {
-    // initalize all 4 ring buffers set starting index's
-    rb_initialize_F( &p_filt->numerator );
-    rb_initialize_F( &p_filt->denominator );
-    rb_initialize_F( &p_filt->out_list );
-    rb_initialize_F( &p_filt->in_list );
-
-    // num coefficents = order + 1
-    for ( uint8_t i = 0; i <= order; i++ ) {
-        // push back all coefficients 
-        rb_push_back_F( &p_filt->numerator, numerator_coeffs[i] );
-        rb_push_back_F( &p_filt->denominator, denominator_coeffs[i] );
-        // initalize in and out list to 0
-        rb_push_back_F( &p_filt->in_list, 0 );
-        rb_push_back_F( &p_filt->out_list, 0 );
-    }
+    // load the coefficients and zero the history, sized to the number of coefficients
+    filter_load_coeffs( &p_filt->numerator, &p_filt->denominator, numerator_coeffs, denominator_coeffs, order );
+    filter_zero_history( &p_filt->in_list, &p_filt->out_list, order + 1 );
 
     return;
 }
@@ -127,106 +184,220 @@ void Filter_SetTo( Filter_Data_t* p_filt, float amount )
  */
 float Filter_Value( Filter_Data_t* p_filt, float value )
 {
-    // length values 
-    uint8_t length = rb_length_F( &p_filt->numerator );
-    
-    float in_sum = 0;
-    float out_sum = 0;
-
-
-    // print_rb(&p_filt->in_list);
-
-    // pop oldest and add newest 
-    rb_pop_front_F( &p_filt->in_list ); 
-    // rb_push_back_F( &p_filt->in_list , value ); 
+    return filter_step( &p_filt->numerator, &p_filt->denominator, &p_filt->in_list, &p_filt->out_list, value );
+}
 
-    // stored num b0, b1...
-    // stored den a0, a1...
-    // constants a0 and b0 
-    float b0 = rb_pop_front_F( &p_filt->numerator );
-    float a0 = rb_pop_front_F( &p_filt->denominator );
-    float in_n = value;
-    float out_n = rb_pop_front_F( &p_filt->out_list ); // pop oldest y_1 where y_n is now
-    
-    rb_push_back_F( &p_filt->numerator, b0 );
-    rb_push_back_F( &p_filt->denominator , a0 );
-    // rb_push_back_F( &p_filt->in_list , in_n );
-    // rb_push_back_F( &p_filt->out_list , out_n );  // oldest push but will remove 
+/**
+ * Function Filter_Value_Block filters a block of values, identical to calling Filter_Value for each value in turn.
+ * @param p_filt pointer to the filter object
+ * @param p_in the new measurements or values
+ * @param p_out destination for the filtered values
+ * @param count number of values
+ */
+void Filter_Value_Block( Filter_Data_t* p_filt, const float* p_in, float* p_out, size_t count )
+{
+    uint8_t length = rb_length_F( &p_filt->numerator );
+    if( length == 0 || count == 0 )
+        return;
+
+    float num[RB_LENGTH_F];
+    float den[RB_LENGTH_F];
+    float in[RB_LENGTH_F];
+    float out[RB_LENGTH_F];
+
+    for( uint8_t i = 0; i < length; i++ ) {
+        num[i] = rb_get_F( &p_filt->numerator, i );
+        den[i] = rb_get_F( &p_filt->denominator, i );
+        in[i]  = rb_get_F( &p_filt->in_list, i );
+        out[i] = rb_get_F( &p_filt->out_list, i );
+    }
 
+    // in and out are now circular with the newest sample at index newest
+    uint8_t newest = length - 1;
+
+    for( size_t k = 0; k < count; k++ ) {
+        newest     = ( newest == length - 1 ) ? 0 : newest + 1;
+        in[newest] = p_in[k];
+
+        // same summation order as filter_eval so the results match Filter_Value exactly
+        float in_sum  = 0;
+        float out_sum = 0;
+        uint8_t j     = newest;
+        for( uint8_t i = 0; i < length; i++ ) {
+            in_sum += num[i] * in[j];
+            if( i > 0 )
+                out_sum += den[i] * out[j];
+            j = ( j == 0 ) ? length - 1 : j - 1;
+        }
+
+        out[newest] = ( in_sum - out_sum ) / den[0];
+        p_out[k]    = out[newest];
+    }
 
-    // print_rb(&p_filt->out_list);
-    // print_rb(&p_filt->out_list);
-    
+    // write the history back oldest first
+    rb_initialize_F( &p_filt->in_list );
+    rb_initialize_F( &p_filt->out_list );
+    for( uint8_t i = 0, j = newest; i < length; i++ ) {
+        j = ( j == length - 1 ) ? 0 : j + 1;
+        rb_push_back_F( &p_filt->in_list, in[j] );
+        rb_push_back_F( &p_filt->out_list, out[j] );
+    }
+}
 
-    // printf( "In and out sum %f, %f, %f, %f, %f, %f\n",a0, b0, in_n, out_n, value, b0*in_n );
+/**
+ * Function Filter_Last_Output returns the most up-to-date filtered value without updating the filter.
+ * @return The latest filtered value
+ */
+float Filter_Last_Output( Filter_Data_t* p_filt )
+{
+    // just return the newest lement in out_list, index is length - 1
+    return rb_get_F( &p_filt->out_list, rb_length_F( &p_filt->out_list ) - 1);
+}
 
+/**
+ * Function Filter_Coeffs_Init loads a coefficient set that can be shared between many filters and zeros its reference
+ * count.
+ * @param p_coeffs pointer to the coefficient set
+ * @param numerator_coeffs The numerator coefficients (B/beta traditionally)
+ * @param denominator_coeffs The denominator coefficients (A/alpha traditionally)
+ * @param order The filter order
+ */
+void Filter_Coeffs_Init( Filter_Coeffs_t* p_coeffs, float* numerator_coeffs, float* denominator_coeffs, uint8_t order )
+{
+    Filter_Coeffs_Load( p_coeffs, numerator_coeffs, denominator_coeffs, order );
+    p_coeffs->ref_count = 0;
+}
 
-    in_sum += b0 * in_n; 
+/**
+ * Function Filter_Coeffs_Load replaces the coefficients of an initialized set and keeps its reference count.
+ * @param p_coeffs pointer to an initialized coefficient set
+ * @param numerator_coeffs The numerator coefficients (B/beta traditionally)
+ * @param denominator_coeffs The denominator coefficients (A/alpha traditionally)
+ * @param order The filter order
+ */
+void Filter_Coeffs_Load( Filter_Coeffs_t* p_coeffs, float* numerator_coeffs, float* denominator_coeffs, uint8_t order )
+{
+    filter_load_coeffs( &p_coeffs->numerator, &p_coeffs->denominator, numerator_coeffs, denominator_coeffs, order );
+}
 
-    // inputs
-    for (uint8_t i = 0; i < length - 1; i++)
-    {
+/**
+ * Function Filter_Shared_Init attaches a filter to a coefficient set and zeros its history.
+ * @param p_filt pointer to the shared filter object
+ * @param p_coeffs pointer to an initialized coefficient set
+ */
+void Filter_Shared_Init( Filter_Shared_t* p_filt, Filter_Coeffs_t* p_coeffs )
+{
+    p_coeffs->ref_count++;
+    p_filt->p_coeffs = p_coeffs;
+    filter_zero_history( &p_filt->in_list, &p_filt->out_list, rb_length_F( &p_coeffs->numerator ) );
+}
 
-        // pop input back and push front go from 1 to N
-        float num_b = rb_pop_front_F( &p_filt->numerator );
-        float den_a = rb_pop_front_F( &p_filt->denominator ); 
-        float in_x = rb_pop_back_F( &p_filt->in_list ); 
-        float out_y = rb_pop_back_F( &p_filt->out_list ); 
+/**
+ * Function Filter_Shared_Release detaches a filter from its coefficient set and decrements the reference count.
+ * @param p_filt pointer to the shared filter object
+ */
+void Filter_Shared_Release( Filter_Shared_t* p_filt )
+{
+    if( p_filt->p_coeffs == NULL )
+        return;
 
-        rb_push_back_F( &p_filt->numerator, num_b );
-        rb_push_back_F( &p_filt->denominator , den_a );
-        rb_push_front_F( &p_filt->in_list , in_x );
-        rb_push_front_F( &p_filt->out_list , out_y );
+    p_filt->p_coeffs->ref_count--;
+    p_filt->p_coeffs = NULL;
+}
 
-        
-        // printf( "x, y, %f, %f\n",rb_pop_back_F( &p_filt->in_list ), rb_pop_back_F( &p_filt->out_list ) );
+/**
+ * Function Filter_Shared_Value adds a new value to a shared-coefficient filter and returns the new output.
+ * @param p_filt pointer to the shared filter object
+ * @param value the new measurement or value
+ * @return The newly filtered value
+ */
+float Filter_Shared_Value( Filter_Shared_t* p_filt, float value )
+{
+    return filter_step( &p_filt->p_coeffs->numerator, &p_filt->p_coeffs->denominator, &p_filt->in_list, &p_filt->out_list, value );
+}
 
-        
-        // print_rb(&p_filt->in_list);
-        // print_rb(&p_filt->out_list);
-        // // printf( "x, y, %f, %f\n",in_x, out_y );
+/**
+ * Function Filter_Shared_Last_Output returns the most up-to-date filtered value without updating the filter.
+ * @return The latest filtered value
+ */
+float Filter_Shared_Last_Output( const Filter_Shared_t* p_filt )
+{
+    return rb_get_F( &p_filt->out_list, rb_length_F( &p_filt->out_list ) - 1 );
+}
 
-        
-        // print_rb(&p_filt->out_list);
+/**
+ * Function Filter_Ramp_Init puts the crossfade state into its idle state.
+ * @param p_ramp pointer to the crossfade state
+ */
+void Filter_Ramp_Init( Filter_Ramp_t* p_ramp )
+{
+    p_ramp->length   = 0;
+    p_ramp->position = 0;
+}
 
+/**
+ * Function Filter_Retune starts a crossfade from the filter's current coefficients to a new set over ramp_samples
+ * calls to Filter_Ramp_Value. The history is kept. If the order changes the history cannot be kept and the filter is
+ * re-initialized as with Filter_Init.
+ * @param p_filt pointer to the filter object
+ * @param p_ramp pointer to the crossfade state
+ * @param numerator_coeffs The new numerator coefficients (B/beta traditionally)
+ * @param denominator_coeffs The new denominator coefficients (A/alpha traditionally)
+ * @param order The filter order
+ * @param ramp_samples Number of samples to crossfade over, 0 switches immediately
+ */
+void Filter_Retune( Filter_Data_t* p_filt, Filter_Ramp_t* p_ramp, float* numerator_coeffs, float* denominator_coeffs, uint8_t order,
+                    uint16_t ramp_samples )
+{
+    Filter_Ramp_Init( p_ramp );
 
-        // printf( "In and out sum %i, %f, %f, %f, %f\n",i ,num_b, den_a, in_x, out_y );
+    if( rb_length_F( &p_filt->numerator ) != order + 1 ) {
+        Filter_Init( p_filt, numerator_coeffs, denominator_coeffs, order );
+        return;
+    }
 
+    if( ramp_samples == 0 ) {
+        filter_load_coeffs( &p_filt->numerator, &p_filt->denominator, numerator_coeffs, denominator_coeffs, order );
+        return;
+    }
 
-        in_sum += num_b * in_x;
-        out_sum += den_a * out_y;
-        // printf( "In and out sum %i, %f, %f, %f, %f, %f, %f, %f\n", i, num_b, den_a, in_x, out_y, in_sum, out_sum, value );
+    Filter_Coeffs_Init( &p_ramp->target, numerator_coeffs, denominator_coeffs, order );
+    p_ramp->length = ramp_samples;
+}
 
-    }
+/**
+ * Function Filter_Ramp_Value adds a new value to a filter that may be crossfading to new coefficients. While the
+ * crossfade runs the outputs of both coefficient sets are computed over the same history and blended linearly; when
+ * it completes the filter holds the new coefficients and behaves exactly like Filter_Value.
+ * @param p_filt pointer to the filter object
+ * @param p_ramp pointer to the crossfade state
+ * @param value the new measurement or value
+ * @return The newly filtered value
+ */
+float Filter_Ramp_Value( Filter_Data_t* p_filt, Filter_Ramp_t* p_ramp, float value )
+{
+    if( p_ramp->position >= p_ramp->length )
+        return Filter_Value( p_filt, value );
 
-    // calculate output value 
-    float out_val = ( in_sum - out_sum ) / a0;
+    filter_shift_in( &p_filt->in_list, &p_filt->out_list, value );
 
-    printf("out val %f\n", out_val);
+    float old_val = filter_eval( &p_filt->numerator, &p_filt->denominator, &p_filt->in_list, &p_filt->out_list );
+    float new_val = filter_eval( &p_ramp->target.numerator, &p_ramp->target.denominator, &p_filt->in_list, &p_filt->out_list );
 
+    p_ramp->position++;
+    float out_val = old_val + ( new_val - old_val ) * p_ramp->position / p_ramp->length;
 
-    // once complete push back newest x
-    rb_push_back_F( &p_filt->in_list , in_n );
-    // push back newest y 
-    rb_push_back_F( &p_filt->out_list , out_val );
+    rb_push_back_F( &p_filt->out_list, out_val );
 
-    // pop oldest out push newest 
-    // rb_pop_front_F( &p_filt->out_list ); 
-    // rb_push_back_F( &p_filt->out_list , out_val );
+    // fully faded, the target becomes the filter's own coefficients
+    if( p_ramp->position == p_ramp->length ) {
+        p_filt->numerator   = p_ramp->target.numerator;
+        p_filt->denominator = p_ramp->target.denominator;
+    }
 
     return out_val;
 }
 
-/**
- * Function Filter_Last_Output returns the most up-to-date filtered value without updating the filter.
- * @return The latest filtered value
- */
-float Filter_Last_Output( Filter_Data_t* p_filt )
-{
-    // just return the newest lement in out_list, index is length - 1
-    return rb_get_F( &p_filt->out_list, rb_length_F( &p_filt->out_list ) - 1);
-}
-
 // Function print_rb 
 // printing values in a given ring buffer
 void print_rb(Ring_Buffer_Float_t* print_f) {
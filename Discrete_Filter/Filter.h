@@ -46,6 +46,8 @@
  
 #include "Ring_Buffer.h"
 
+#include <stddef.h>  // for size_t
+
 typedef struct {
     Ring_Buffer_Float_t numerator;
     Ring_Buffer_Float_t denominator;
@@ -53,6 +55,30 @@ typedef struct {
     Ring_Buffer_Float_t in_list;
 } Filter_Data_t;
 
+// A coefficient set that many filters can point to. ref_count tracks how many Filter_Shared_t objects are using it so
+// the owner knows when it is safe to re-initialize or release the storage.
+typedef struct {
+    Ring_Buffer_Float_t numerator;
+    Ring_Buffer_Float_t denominator;
+    uint16_t ref_count;
+} Filter_Coeffs_t;
+
+// A filter whose coefficients live in a shared Filter_Coeffs_t. Only the history is stored per instance, so it is
+// roughly half the size of a Filter_Data_t.
+typedef struct {
+    Filter_Coeffs_t* p_coeffs;
+    Ring_Buffer_Float_t out_list;
+    Ring_Buffer_Float_t in_list;
+} Filter_Shared_t;
+
+// Crossfade state used by Filter_Retune/Filter_Ramp_Value. Kept separate from Filter_Data_t so filters that never
+// retune do not carry it.
+typedef struct {
+    Filter_Coeffs_t target;
+    uint16_t length;    // crossfade length in samples
+    uint16_t position;  // samples completed, the fade is idle once this reaches length
+} Filter_Ramp_t;
+
 /**
  * Function Filter_Init initializes the filter given two float arrays and the order of the filter.  Note that the
  * size of the array will be one larger than the order. (First order systems have two coefficients).
@@ -96,6 +122,17 @@ void Filter_SetTo( Filter_Data_t* p_filt, float amount );
  */
 float Filter_Value( Filter_Data_t* p_filt, float value );
 
+/**
+ * Function Filter_Value_Block filters a block of values. The outputs are identical to calling Filter_Value for each
+ * value in turn, but the coefficients and history are copied into local arrays once per block rather than going
+ * through the ring buffers on every sample. p_in and p_out may be the same array.
+ * @param p_filt pointer to the filter object
+ * @param p_in the new measurements or values
+ * @param p_out destination for the filtered values
+ * @param count number of values
+ */
+void Filter_Value_Block( Filter_Data_t* p_filt, const float* p_in, float* p_out, size_t count );
+
 /**
  * Function Filter_Last_Output returns the most up-to-date filtered value without updating the filter.
  * @return The latest filtered value
@@ -103,6 +140,88 @@ float Filter_Value( Filter_Data_t* p_filt, float value );
 float Filter_Last_Output( Filter_Data_t* p_filt );
 
 
+/**
+ * Function Filter_Coeffs_Init loads a coefficient set that can be shared between many filters and zeros its reference
+ * count. The arrays follow the same convention as Filter_Init. Use Filter_Coeffs_Load to change a set that filters
+ * are already attached to.
+ * @param p_coeffs pointer to the coefficient set
+ * @param numerator_coeffs The numerator coefficients (B/beta traditionally)
+ * @param denominator_coeffs The denominator coefficients (A/alpha traditionally)
+ * @param order The filter order
+ */
+void Filter_Coeffs_Init( Filter_Coeffs_t* p_coeffs, float* numerator_coeffs, float* denominator_coeffs, uint8_t order );
+
+/**
+ * Function Filter_Coeffs_Load replaces the coefficients of an initialized set and keeps its reference count. Loading
+ * a set that is still referenced changes the response of every filter using it, but not their history, so the order
+ * should not change while it is referenced.
+ * @param p_coeffs pointer to an initialized coefficient set
+ * @param numerator_coeffs The numerator coefficients (B/beta traditionally)
+ * @param denominator_coeffs The denominator coefficients (A/alpha traditionally)
+ * @param order The filter order
+ */
+void Filter_Coeffs_Load( Filter_Coeffs_t* p_coeffs, float* numerator_coeffs, float* denominator_coeffs, uint8_t order );
+
+/**
+ * Function Filter_Shared_Init attaches a filter to a coefficient set and zeros its history. The set's reference count
+ * is incremented; call Filter_Shared_Release when the filter is no longer used.
+ * @param p_filt pointer to the shared filter object
+ * @param p_coeffs pointer to an initialized coefficient set
+ */
+void Filter_Shared_Init( Filter_Shared_t* p_filt, Filter_Coeffs_t* p_coeffs );
+
+/**
+ * Function Filter_Shared_Release detaches a filter from its coefficient set and decrements the reference count.
+ * @param p_filt pointer to the shared filter object
+ */
+void Filter_Shared_Release( Filter_Shared_t* p_filt );
+
+/**
+ * Function Filter_Shared_Value adds a new value to a shared-coefficient filter and returns the new output.
+ * @param p_filt pointer to the shared filter object
+ * @param value the new measurement or value
+ * @return The newly filtered value
+ */
+float Filter_Shared_Value( Filter_Shared_t* p_filt, float value );
+
+/**
+ * Function Filter_Shared_Last_Output returns the most up-to-date filtered value without updating the filter.
+ * @return The latest filtered value
+ */
+float Filter_Shared_Last_Output( const Filter_Shared_t* p_filt );
+
+/**
+ * Function Filter_Ramp_Init puts the crossfade state into its idle state. Call it before the first Filter_Ramp_Value
+ * unless Filter_Retune has already been called on it.
+ * @param p_ramp pointer to the crossfade state
+ */
+void Filter_Ramp_Init( Filter_Ramp_t* p_ramp );
+
+/**
+ * Function Filter_Retune starts a crossfade from the filter's current coefficients to a new set over ramp_samples
+ * calls to Filter_Ramp_Value. The history is kept. If the order changes the history cannot be kept and the filter is
+ * re-initialized as with Filter_Init.
+ * @param p_filt pointer to the filter object
+ * @param p_ramp pointer to the crossfade state
+ * @param numerator_coeffs The new numerator coefficients (B/beta traditionally)
+ * @param denominator_coeffs The new denominator coefficients (A/alpha traditionally)
+ * @param order The filter order
+ * @param ramp_samples Number of samples to crossfade over, 0 switches immediately
+ */
+void Filter_Retune( Filter_Data_t* p_filt, Filter_Ramp_t* p_ramp, float* numerator_coeffs, float* denominator_coeffs, uint8_t order,
+                    uint16_t ramp_samples );
+
+/**
+ * Function Filter_Ramp_Value adds a new value to a filter that may be crossfading to new coefficients. The outputs of
+ * both coefficient sets are blended linearly over the crossfade; afterwards it behaves exactly like Filter_Value. The
+ * crossfade state must have been set up by Filter_Ramp_Init or Filter_Retune.
+ * @param p_filt pointer to the filter object
+ * @param p_ramp pointer to the crossfade state
+ * @param value the new measurement or value
+ * @return The newly filtered value
+ */
+float Filter_Ramp_Value( Filter_Data_t* p_filt, Filter_Ramp_t* p_ramp, float value );
+
 void print_rb(Ring_Buffer_Float_t* print_f);
 
 #endif
@@ -0,0 +1,303 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Filter_Bank.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>  // for sysconf
+
+// A worker's remaining chunks [begin, end) packed as begin << 32 | end so that taking from the front and stealing
+// from the back are each a single compare and swap. Padded to a cache line so workers do not share lines.
+typedef struct {
+    _Atomic uint64_t range;
+    uint32_t steals;
+    char pad[64 - sizeof( uint64_t ) - sizeof( uint32_t )];
+} Bank_Worker_t;
+
+typedef struct {
+    Filter_Channel_t* p_channels;
+    uint32_t count;
+    uint32_t chunk_channels;
+    uint16_t threads;
+    Bank_Worker_t* p_workers;
+} Bank_Job_t;
+
+#define RANGE( begin, end ) ( ( (uint64_t)( begin ) << 32 ) | ( end ) )
+#define RANGE_BEGIN( r )    ( (uint32_t)( ( r ) >> 32 ) )
+#define RANGE_END( r )      ( (uint32_t)( r ) )
+
+// Takes the next chunk from the front of the worker's own range.
+static bool take_own( Bank_Worker_t* p_self, uint32_t* p_chunk )
+{
+    uint64_t r = atomic_load( &p_self->range );
+    while( RANGE_BEGIN( r ) < RANGE_END( r ) ) {
+        if( atomic_compare_exchange_weak( &p_self->range, &r, RANGE( RANGE_BEGIN( r ) + 1, RANGE_END( r ) ) ) ) {
+            *p_chunk = RANGE_BEGIN( r );
+            return true;
+        }
+    }
+    return false;
+}
+
+// Steals the back half of another worker's range into the worker's own (empty) range.
+static bool steal( Bank_Job_t* p_job, uint16_t id )
+{
+    for( uint16_t k = 1; k < p_job->threads; k++ ) {
+        Bank_Worker_t* p_victim = &p_job->p_workers[( id + k ) % p_job->threads];
+        uint64_t r              = atomic_load( &p_victim->range );
+
+        while( RANGE_BEGIN( r ) < RANGE_END( r ) ) {
+            uint32_t take = ( RANGE_END( r ) - RANGE_BEGIN( r ) + 1 ) / 2;
+            uint32_t cut  = RANGE_END( r ) - take;
+            if( atomic_compare_exchange_weak( &p_victim->range, &r, RANGE( RANGE_BEGIN( r ), cut ) ) ) {
+                // nobody modifies an empty range, so a plain store is enough
+                atomic_store( &p_job->p_workers[id].range, RANGE( cut, RANGE_END( r ) ) );
+                p_job->p_workers[id].steals++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void bank_work( Bank_Job_t* p_job, uint16_t id )
+{
+    uint32_t chunk;
+
+    // chunks are never created during a run, so once every range is empty the work is done
+    do {
+        while( take_own( &p_job->p_workers[id], &chunk ) ) {
+            uint32_t first = chunk * p_job->chunk_channels;
+            uint32_t last  = first + p_job->chunk_channels;
+            if( last > p_job->count )
+                last = p_job->count;
+
+            for( uint32_t c = first; c < last; c++ )
+                Filter_Channel_Run( &p_job->p_channels[c] );
+        }
+    } while( steal( p_job, id ) );
+}
+
+// A pool worker sleeps until a new generation is posted, takes its part in that run and reports back.
+static void* pool_worker( void* p_arg )
+{
+    Filter_Bank_Pool_t* p_pool = ( (Filter_Bank_Slot_t*)p_arg )->p_pool;
+    uint16_t id                = ( (Filter_Bank_Slot_t*)p_arg )->id;
+    uint64_t seen              = 0;
+
+    pthread_mutex_lock( &p_pool->lock );
+    for( ;; ) {
+        while( p_pool->generation == seen && !p_pool->stopping )
+            pthread_cond_wait( &p_pool->start, &p_pool->lock );
+        if( p_pool->stopping )
+            break;
+
+        seen              = p_pool->generation;
+        Bank_Job_t* p_job = p_pool->p_job;
+        pthread_mutex_unlock( &p_pool->lock );
+
+        // runs with fewer chunks than workers leave the extra workers idle
+        if( id < p_job->threads )
+            bank_work( p_job, id );
+
+        pthread_mutex_lock( &p_pool->lock );
+        if( --p_pool->running == 0 )
+            pthread_cond_signal( &p_pool->done );
+    }
+    pthread_mutex_unlock( &p_pool->lock );
+    return NULL;
+}
+
+static uint16_t bank_threads( uint16_t threads )
+{
+    if( threads == 0 ) {
+        long cpus = sysconf( _SC_NPROCESSORS_ONLN );
+        threads   = ( cpus > 0 ) ? cpus : 1;
+    }
+    return ( threads > FILTER_BANK_MAX_THREADS ) ? FILTER_BANK_MAX_THREADS : threads;
+}
+
+static uint32_t bank_chunk_channels( const Filter_Channel_t* p_channels, uint32_t count, uint32_t chunk_channels )
+{
+    if( chunk_channels == 0 ) {
+        size_t state   = ( count > 0 && p_channels[0].stage_count > 0 ) ? p_channels[0].stage_count * sizeof( Filter_Data_t ) : sizeof( Filter_Data_t );
+        chunk_channels = FILTER_BANK_CHUNK_BYTES / state;
+        if( chunk_channels == 0 )
+            chunk_channels = 1;
+    }
+    return chunk_channels;
+}
+
+/**
+ * Function Filter_Channel_Run filters one channel on the calling thread, block by block through every stage.
+ * @param p_channel pointer to the channel
+ */
+void Filter_Channel_Run( Filter_Channel_t* p_channel )
+{
+    for( size_t offset = 0; offset < p_channel->length; offset += FILTER_BANK_BLOCK ) {
+        size_t count = p_channel->length - offset;
+        if( count > FILTER_BANK_BLOCK )
+            count = FILTER_BANK_BLOCK;
+
+        const float* p_in = p_channel->p_input + offset;
+        float* p_out      = p_channel->p_output + offset;
+
+        // first stage moves the block to the output, the rest work in place while it is still in cache
+        for( uint8_t s = 0; s < p_channel->stage_count; s++ ) {
+            Filter_Value_Block( &p_channel->p_stages[s], p_in, p_out, count );
+            p_in = p_out;
+        }
+    }
+}
+
+/**
+ * Function Filter_Bank_Pool_Start starts the workers of a pool. Workers that fail to start are left out, their share
+ * of every run is stolen by the others.
+ * @param p_pool pointer to the pool
+ * @param threads number of workers including the caller, 0 for one per online CPU
+ */
+void Filter_Bank_Pool_Start( Filter_Bank_Pool_t* p_pool, uint16_t threads )
+{
+    pthread_mutex_init( &p_pool->lock, NULL );
+    pthread_cond_init( &p_pool->start, NULL );
+    pthread_cond_init( &p_pool->done, NULL );
+    p_pool->threads    = bank_threads( threads );
+    p_pool->running    = 0;
+    p_pool->generation = 0;
+    p_pool->stopping   = false;
+    p_pool->p_job      = NULL;
+
+    for( uint16_t t = 1; t < p_pool->threads; t++ ) {
+        p_pool->slots[t].p_pool = p_pool;
+        p_pool->slots[t].id     = t;
+        p_pool->started[t]      = pthread_create( &p_pool->handles[t], NULL, pool_worker, &p_pool->slots[t] ) == 0;
+    }
+}
+
+/**
+ * Function Filter_Bank_Pool_Run filters every channel to completion on the pool's workers, like Filter_Bank_Run.
+ * @param p_pool pointer to a started pool, run from one thread at a time
+ * @param p_channels array of channels
+ * @param count number of channels
+ * @param chunk_channels channels per chunk, 0 to size chunks by FILTER_BANK_CHUNK_BYTES
+ * @param p_stats optional destination for run statistics, may be NULL
+ */
+void Filter_Bank_Pool_Run( Filter_Bank_Pool_t* p_pool, Filter_Channel_t* p_channels, uint32_t count, uint32_t chunk_channels, Filter_Bank_Stats_t* p_stats )
+{
+    chunk_channels   = bank_chunk_channels( p_channels, count, chunk_channels );
+    uint32_t chunks  = ( count + chunk_channels - 1 ) / chunk_channels;
+    uint16_t threads = p_pool->threads;
+    if( threads > chunks )
+        threads = ( chunks > 0 ) ? chunks : 1;
+
+    Bank_Worker_t workers[FILTER_BANK_MAX_THREADS] __attribute__( ( aligned( 64 ) ) );
+    Bank_Job_t job = { p_channels, count, chunk_channels, threads, workers };
+
+    // equal contiguous ranges to start, stealing evens out whatever imbalance is left
+    for( uint16_t t = 0; t < threads; t++ ) {
+        atomic_init( &workers[t].range, RANGE( (uint64_t)chunks * t / threads, (uint64_t)chunks * ( t + 1 ) / threads ) );
+        workers[t].steals = 0;
+    }
+
+    uint16_t running = 0;
+    for( uint16_t t = 1; t < p_pool->threads; t++ )
+        running += p_pool->started[t];
+
+    pthread_mutex_lock( &p_pool->lock );
+    p_pool->p_job   = &job;
+    p_pool->running = running;
+    p_pool->generation++;
+    pthread_cond_broadcast( &p_pool->start );
+    pthread_mutex_unlock( &p_pool->lock );
+
+    bank_work( &job, 0 );
+
+    // workers still hold pointers into job and workers until they report back
+    pthread_mutex_lock( &p_pool->lock );
+    while( p_pool->running > 0 )
+        pthread_cond_wait( &p_pool->done, &p_pool->lock );
+    p_pool->p_job = NULL;
+    pthread_mutex_unlock( &p_pool->lock );
+
+    uint32_t steals = 0;
+    for( uint16_t t = 0; t < threads; t++ )
+        steals += workers[t].steals;
+
+    if( p_stats != NULL ) {
+        p_stats->threads = threads;
+        p_stats->chunks  = chunks;
+        p_stats->steals  = steals;
+    }
+}
+
+/**
+ * Function Filter_Bank_Pool_Stop wakes and joins the pool's workers.
+ * @param p_pool pointer to a started pool with no run in progress
+ */
+void Filter_Bank_Pool_Stop( Filter_Bank_Pool_t* p_pool )
+{
+    pthread_mutex_lock( &p_pool->lock );
+    p_pool->stopping = true;
+    pthread_cond_broadcast( &p_pool->start );
+    pthread_mutex_unlock( &p_pool->lock );
+
+    for( uint16_t t = 1; t < p_pool->threads; t++ )
+        if( p_pool->started[t] )
+            pthread_join( p_pool->handles[t], NULL );
+
+    pthread_cond_destroy( &p_pool->done );
+    pthread_cond_destroy( &p_pool->start );
+    pthread_mutex_destroy( &p_pool->lock );
+}
+
+/**
+ * Function Filter_Bank_Run filters every channel to completion.
+ * @param p_channels array of channels
+ * @param count number of channels
+ * @param threads number of workers including the caller, 0 for one per online CPU
+ * @param chunk_channels channels per chunk, 0 to size chunks by FILTER_BANK_CHUNK_BYTES
+ * @param p_stats optional destination for run statistics, may be NULL
+ */
+void Filter_Bank_Run( Filter_Channel_t* p_channels, uint32_t count, uint16_t threads, uint32_t chunk_channels, Filter_Bank_Stats_t* p_stats )
+{
+    chunk_channels  = bank_chunk_channels( p_channels, count, chunk_channels );
+    uint32_t chunks = ( count + chunk_channels - 1 ) / chunk_channels;
+
+    // a one-off run only starts the workers it has chunks for
+    threads = bank_threads( threads );
+    if( threads > chunks )
+        threads = ( chunks > 0 ) ? chunks : 1;
+
+    Filter_Bank_Pool_t pool;
+    Filter_Bank_Pool_Start( &pool, threads );
+    Filter_Bank_Pool_Run( &pool, p_channels, count, chunk_channels, p_stats );
+    Filter_Bank_Pool_Stop( &pool );
+}
@@ -0,0 +1,142 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/**
+ * Filter_Bank.h/c processes many independent channels, each a chain of Filter_Data_t stages over a recorded signal,
+ * across all cores.
+ *
+ * Channels are grouped into chunks whose filter state fits in FILTER_BANK_CHUNK_BYTES. Each worker thread starts with
+ * an equal contiguous range of chunks, takes chunks from the front of its own range and, once it runs dry, steals half
+ * of the remaining range from the back of another worker. A whole channel is always processed by one thread, in
+ * blocks of FILTER_BANK_BLOCK samples that pass through every stage while they are in L1, so the outputs are
+ * identical to calling Filter_Value sample by sample.
+ *
+ * The calling thread works as one of the workers. Filter_Bank_Run starts and joins its workers on every call; a
+ * caller that filters a stream block by block starts a Filter_Bank_Pool_t once instead and runs every block on the
+ * same workers, which sleep on a condition variable between runs. Requires pthreads and C11 atomics, so this is not
+ * built for AVR_MCU.
+ */
+#ifndef _MEGN540_FILTER_BANK_H
+#define _MEGN540_FILTER_BANK_H
+
+#include "Filter.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#ifndef FILTER_BANK_BLOCK
+#    define FILTER_BANK_BLOCK 256  // samples per block passed through a channel's stages
+#endif
+
+#ifndef FILTER_BANK_CHUNK_BYTES
+#    define FILTER_BANK_CHUNK_BYTES 32768  // filter state per chunk, about one L1 data cache
+#endif
+
+#ifndef FILTER_BANK_MAX_THREADS
+#    define FILTER_BANK_MAX_THREADS 64
+#endif
+
+// one channel: p_input filtered through stage_count filters in series into p_output (which may equal p_input)
+typedef struct {
+    Filter_Data_t* p_stages;
+    uint8_t stage_count;
+    const float* p_input;
+    float* p_output;
+    size_t length;
+} Filter_Channel_t;
+
+typedef struct {
+    uint16_t threads;  // workers used, including the caller
+    uint32_t chunks;
+    uint32_t steals;   // successful steals across all workers
+} Filter_Bank_Stats_t;
+
+// what a pool worker is started with
+typedef struct {
+    struct Filter_Bank_Pool* p_pool;
+    uint16_t id;
+} Filter_Bank_Slot_t;
+
+// workers kept alive between runs, worker 0 is whichever thread calls Filter_Bank_Pool_Run
+typedef struct Filter_Bank_Pool {
+    pthread_mutex_t lock;
+    pthread_cond_t start;  // a run was posted or the pool is stopping
+    pthread_cond_t done;   // the last worker finished the current run
+    pthread_t handles[FILTER_BANK_MAX_THREADS];
+    bool started[FILTER_BANK_MAX_THREADS];
+    Filter_Bank_Slot_t slots[FILTER_BANK_MAX_THREADS];
+    uint16_t threads;     // workers including the caller
+    uint16_t running;     // started workers not yet finished with the current run
+    uint64_t generation;  // incremented for every run
+    bool stopping;
+    void* p_job;  // the current run
+} Filter_Bank_Pool_t;
+
+/**
+ * Function Filter_Bank_Run filters every channel to completion.
+ * @param p_channels array of channels
+ * @param count number of channels
+ * @param threads number of workers including the caller, 0 for one per online CPU
+ * @param chunk_channels channels per chunk, 0 to size chunks by FILTER_BANK_CHUNK_BYTES
+ * @param p_stats optional destination for run statistics, may be NULL
+ */
+void Filter_Bank_Run( Filter_Channel_t* p_channels, uint32_t count, uint16_t threads, uint32_t chunk_channels, Filter_Bank_Stats_t* p_stats );
+
+/**
+ * Function Filter_Bank_Pool_Start starts the workers of a pool. Workers that fail to start are left out, their share
+ * of every run is stolen by the others.
+ * @param p_pool pointer to the pool
+ * @param threads number of workers including the caller, 0 for one per online CPU
+ */
+void Filter_Bank_Pool_Start( Filter_Bank_Pool_t* p_pool, uint16_t threads );
+
+/**
+ * Function Filter_Bank_Pool_Run filters every channel to completion on the pool's workers, like Filter_Bank_Run.
+ * @param p_pool pointer to a started pool, run from one thread at a time
+ * @param p_channels array of channels
+ * @param count number of channels
+ * @param chunk_channels channels per chunk, 0 to size chunks by FILTER_BANK_CHUNK_BYTES
+ * @param p_stats optional destination for run statistics, may be NULL
+ */
+void Filter_Bank_Pool_Run( Filter_Bank_Pool_t* p_pool, Filter_Channel_t* p_channels, uint32_t count, uint32_t chunk_channels, Filter_Bank_Stats_t* p_stats );
+
+/**
+ * Function Filter_Bank_Pool_Stop wakes and joins the pool's workers.
+ * @param p_pool pointer to a started pool with no run in progress
+ */
+void Filter_Bank_Pool_Stop( Filter_Bank_Pool_t* p_pool );
+
+/**
+ * Function Filter_Channel_Run filters one channel on the calling thread, block by block through every stage.
+ * @param p_channel pointer to the channel
+ */
+void Filter_Channel_Run( Filter_Channel_t* p_channel );
+
+#endif
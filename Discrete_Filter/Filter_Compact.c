@@ -0,0 +1,132 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Filter_Compact.h"
+
+// offsets of the four arrays packed into data[], each order+1 long
+#define NUM( p_filt ) ( ( p_filt )->data )
+#define DEN( p_filt ) ( ( p_filt )->data + ( p_filt )->order + 1 )
+#define IN( p_filt )  ( ( p_filt )->data + 2 * ( ( p_filt )->order + 1 ) )
+#define OUT( p_filt ) ( ( p_filt )->data + 3 * ( ( p_filt )->order + 1 ) )
+
+/**
+ * Function Filter_Size returns the number of bytes needed to hold a compact filter of the given order.
+ * @param order The filter order
+ * @return The storage size in bytes
+ */
+size_t Filter_Size( uint8_t order )
+{
+    return FILTER_SIZE( order );
+}
+
+/**
+ * Function Filter_Compact_Init initializes a compact filter in caller provided storage.
+ * @param p_storage pointer to at least Filter_Size( order ) bytes, aligned for float
+ * @param numerator_coeffs The numerator coefficients (B/beta traditionally)
+ * @param denominator_coeffs The denominator coefficients (A/alpha traditionally)
+ * @param order The filter order
+ * @return p_storage as a filter object
+ */
+Filter_Compact_t* Filter_Compact_Init( void* p_storage, float* numerator_coeffs, float* denominator_coeffs, uint8_t order )
+{
+    Filter_Compact_t* p_filt = (Filter_Compact_t*)p_storage;
+
+    p_filt->order  = order;
+    p_filt->newest = 0;
+
+    // 16 bit counters so an order of 255 terminates
+    for( uint16_t i = 0; i <= order; i++ ) {
+        NUM( p_filt )[i] = numerator_coeffs[i];
+        DEN( p_filt )[i] = denominator_coeffs[i];
+    }
+
+    Filter_Compact_SetTo( p_filt, 0 );
+
+    return p_filt;
+}
+
+/**
+ * Function Filter_Compact_SetTo sets the input and output history to a constant value.
+ * @param p_filt pointer to the filter object
+ * @param amount The value to re-initialize the filter to.
+ */
+void Filter_Compact_SetTo( Filter_Compact_t* p_filt, float amount )
+{
+    for( uint16_t i = 0; i <= p_filt->order; i++ ) {
+        IN( p_filt )[i]  = amount;
+        OUT( p_filt )[i] = amount;
+    }
+}
+
+/**
+ * Function Filter_Compact_Value adds a new value to the filter and returns the new output.
+ * @param p_filt pointer to the filter object
+ * @param value the new measurement or value
+ * @return The newly filtered value
+ */
+float Filter_Compact_Value( Filter_Compact_t* p_filt, float value )
+{
+    const float* num = NUM( p_filt );
+    const float* den = DEN( p_filt );
+    float* in        = IN( p_filt );
+    float* out       = OUT( p_filt );
+    uint8_t order    = p_filt->order;
+
+    // advance the newest index over the oldest sample, which is no longer needed
+    uint8_t n = ( p_filt->newest == order ) ? 0 : p_filt->newest + 1;
+    in[n]     = value;
+
+    float in_sum  = num[0] * value;
+    float out_sum = 0;
+
+    // walk back through the history, wrapping without a modulo
+    uint8_t j = n;
+    for( uint16_t i = 1; i <= order; i++ ) {
+        j = ( j == 0 ) ? order : j - 1;
+        in_sum += num[i] * in[j];
+        out_sum += den[i] * out[j];
+    }
+
+    float out_val = ( in_sum - out_sum ) / den[0];
+
+    out[n]         = out_val;
+    p_filt->newest = n;
+
+    return out_val;
+}
+
+/**
+ * Function Filter_Compact_Last_Output returns the most up-to-date filtered value without updating the filter.
+ * @return The latest filtered value
+ */
+float Filter_Compact_Last_Output( const Filter_Compact_t* p_filt )
+{
+    return OUT( p_filt )[p_filt->newest];
+}
@@ -0,0 +1,100 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/**
+ * Filter_Compact.h/c defines a z-transform filter whose storage is sized to the filter order rather than to
+ * RB_LENGTH_F. The coefficients and history live in a flexible array member directly after a two byte header, so a
+ * first order filter takes 36 bytes instead of the 144 of a Filter_Data_t, and the order is not limited by the ring
+ * buffer length.
+ *
+ * Storage is always provided by the caller (static array, arena or pool block) and must be at least
+ * FILTER_SIZE( order ) bytes and aligned for float. FILTER_SIZE is a constant expression for a constant order, so it
+ * can size static or file scope arrays; Filter_Size gives the same value at run time.
+ *
+ *  static uint8_t storage[FILTER_SIZE( 1 )] __attribute__( ( aligned( 4 ) ) );
+ *  Filter_Compact_t* p_filt = Filter_Compact_Init( storage, num, den, 1 );
+ *
+ */
+#ifndef _MEGN540_FILTER_COMPACT_H
+#define _MEGN540_FILTER_COMPACT_H
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint8_t type
+
+typedef struct {
+    uint8_t order;
+    uint8_t newest;  // index of x_n/y_n within the history arrays
+    float data[];    // B[order+1], A[order+1], x[order+1], y[order+1]
+} Filter_Compact_t;
+
+// bytes needed to hold a compact filter of the given order
+#define FILTER_SIZE( order ) ( sizeof( Filter_Compact_t ) + 4 * ( (size_t)( order ) + 1 ) * sizeof( float ) )
+
+/**
+ * Function Filter_Size returns the number of bytes needed to hold a compact filter of the given order, the same as
+ * FILTER_SIZE( order ).
+ * @param order The filter order
+ * @return The storage size in bytes
+ */
+size_t Filter_Size( uint8_t order );
+
+/**
+ * Function Filter_Compact_Init initializes a compact filter in caller provided storage. The coefficient convention is
+ * the same as Filter_Init and the history is zeroed.
+ * @param p_storage pointer to at least Filter_Size( order ) bytes, aligned for float
+ * @param numerator_coeffs The numerator coefficients (B/beta traditionally)
+ * @param denominator_coeffs The denominator coefficients (A/alpha traditionally)
+ * @param order The filter order, up to 255
+ * @return p_storage as a filter object
+ */
+Filter_Compact_t* Filter_Compact_Init( void* p_storage, float* numerator_coeffs, float* denominator_coeffs, uint8_t order );
+
+/**
+ * Function Filter_Compact_SetTo sets the input and output history to a constant value.
+ * @param p_filt pointer to the filter object
+ * @param amount The value to re-initialize the filter to.
+ */
+void Filter_Compact_SetTo( Filter_Compact_t* p_filt, float amount );
+
+/**
+ * Function Filter_Compact_Value adds a new value to the filter and returns the new output.
+ * @param p_filt pointer to the filter object
+ * @param value the new measurement or value
+ * @return The newly filtered value
+ */
+float Filter_Compact_Value( Filter_Compact_t* p_filt, float value );
+
+/**
+ * Function Filter_Compact_Last_Output returns the most up-to-date filtered value without updating the filter.
+ * @return The latest filtered value
+ */
+float Filter_Compact_Last_Output( const Filter_Compact_t* p_filt );
+
+#endif
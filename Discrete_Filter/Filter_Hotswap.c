@@ -0,0 +1,105 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Filter_Hotswap.h"
+
+/**
+ * Function Filter_Slot_Init loads the initial coefficients. Not thread safe, call before the filter thread starts.
+ * @param p_slot pointer to the coefficient slot
+ * @param numerator_coeffs The numerator coefficients (B/beta traditionally)
+ * @param denominator_coeffs The denominator coefficients (A/alpha traditionally)
+ * @param order The filter order, fixed for the life of the slot
+ */
+void Filter_Slot_Init( Filter_Coeff_Slot_t* p_slot, float* numerator_coeffs, float* denominator_coeffs, uint8_t order )
+{
+    Filter_Coeffs_Init( &p_slot->sets[0], numerator_coeffs, denominator_coeffs, order );
+    Filter_Coeffs_Init( &p_slot->sets[1], numerator_coeffs, denominator_coeffs, order );
+
+    p_slot->active      = 0;
+    p_slot->write_index = 1;
+    atomic_init( &p_slot->pending, 0 );
+}
+
+/**
+ * Function Filter_Slot_Publish makes a new coefficient set available to the filter thread.
+ * @param p_slot pointer to the coefficient slot
+ * @param numerator_coeffs The numerator coefficients (B/beta traditionally)
+ * @param denominator_coeffs The denominator coefficients (A/alpha traditionally)
+ * @param order The filter order, must match the order the slot was initialized with
+ * @return true if published, false if the previous set has not been picked up yet or the order differs
+ */
+bool Filter_Slot_Publish( Filter_Coeff_Slot_t* p_slot, float* numerator_coeffs, float* denominator_coeffs, uint8_t order )
+{
+    // the acquire pairs with the release in Filter_Slot_Acquire, so the filter thread is done with the old set
+    if( atomic_load_explicit( &p_slot->pending, memory_order_acquire ) )
+        return false;
+
+    Filter_Coeffs_t* p_set = &p_slot->sets[p_slot->write_index];
+    if( rb_length_F( &p_set->numerator ) != order + 1 )
+        return false;
+
+    // Load keeps the reference count of any filter that attached to the set through Filter_Shared_Init
+    Filter_Coeffs_Load( p_set, numerator_coeffs, denominator_coeffs, order );
+
+    // the release makes the whole set visible before the flag
+    atomic_store_explicit( &p_slot->pending, 1, memory_order_release );
+    p_slot->write_index ^= 1;
+
+    return true;
+}
+
+/**
+ * Function Filter_Slot_Acquire returns the coefficient set to use for the next sample.
+ * @param p_slot pointer to the coefficient slot
+ * @return The coefficient set to use
+ */
+Filter_Coeffs_t* Filter_Slot_Acquire( Filter_Coeff_Slot_t* p_slot )
+{
+    if( atomic_load_explicit( &p_slot->pending, memory_order_acquire ) ) {
+        p_slot->active ^= 1;
+        atomic_store_explicit( &p_slot->pending, 0, memory_order_release );
+    }
+
+    return &p_slot->sets[p_slot->active];
+}
+
+/**
+ * Function Filter_Slot_Value picks up any newly published coefficients and then filters the value.
+ * @param p_filt pointer to the shared filter object
+ * @param p_slot pointer to the coefficient slot
+ * @param value the new measurement or value
+ * @return The newly filtered value
+ */
+float Filter_Slot_Value( Filter_Shared_t* p_filt, Filter_Coeff_Slot_t* p_slot, float value )
+{
+    p_filt->p_coeffs = Filter_Slot_Acquire( p_slot );
+
+    return Filter_Shared_Value( p_filt, value );
+}
@@ -0,0 +1,97 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/**
+ * Filter_Hotswap.h/c lets a tuning thread replace the coefficients of a running Filter_Shared_t without locks and
+ * without resetting its history.
+ *
+ * The slot holds two coefficient sets. The writer fills the set the filter is not using and raises a pending flag;
+ * the filter thread swaps to it at the start of its next sample and clears the flag. The writer never touches a set
+ * while the flag is raised, so the filter can never see a partially written set. A publish made before the filter
+ * has picked up the previous one is refused and should be retried.
+ *
+ * The filter order is fixed when the slot is initialized since the history length depends on it.
+ *
+ * Requires C11 atomics, so this is not built for AVR_MCU.
+ */
+#ifndef _MEGN540_FILTER_HOTSWAP_H
+#define _MEGN540_FILTER_HOTSWAP_H
+
+#include "Filter.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+typedef struct {
+    Filter_Coeffs_t sets[2];
+    uint8_t active;        // filter thread only: set in use
+    uint8_t write_index;   // writer only: set the next publish fills
+    atomic_uchar pending;  // 1 while a published set waits to be picked up
+} Filter_Coeff_Slot_t;
+
+/**
+ * Function Filter_Slot_Init loads the initial coefficients. Not thread safe, call before the filter thread starts.
+ * @param p_slot pointer to the coefficient slot
+ * @param numerator_coeffs The numerator coefficients (B/beta traditionally)
+ * @param denominator_coeffs The denominator coefficients (A/alpha traditionally)
+ * @param order The filter order, fixed for the life of the slot
+ */
+void Filter_Slot_Init( Filter_Coeff_Slot_t* p_slot, float* numerator_coeffs, float* denominator_coeffs, uint8_t order );
+
+/**
+ * Function Filter_Slot_Publish makes a new coefficient set available to the filter thread. Only one thread may
+ * publish to a slot.
+ * @param p_slot pointer to the coefficient slot
+ * @param numerator_coeffs The numerator coefficients (B/beta traditionally)
+ * @param denominator_coeffs The denominator coefficients (A/alpha traditionally)
+ * @param order The filter order, must match the order the slot was initialized with
+ * @return true if published, false if the previous set has not been picked up yet or the order differs
+ */
+bool Filter_Slot_Publish( Filter_Coeff_Slot_t* p_slot, float* numerator_coeffs, float* denominator_coeffs, uint8_t order );
+
+/**
+ * Function Filter_Slot_Acquire returns the coefficient set to use for the next sample, switching to a newly published
+ * set if there is one. Call only from the filter thread, once per sample.
+ * @param p_slot pointer to the coefficient slot
+ * @return The coefficient set to use
+ */
+Filter_Coeffs_t* Filter_Slot_Acquire( Filter_Coeff_Slot_t* p_slot );
+
+/**
+ * Function Filter_Slot_Value picks up any newly published coefficients and then filters the value. The filter's
+ * coefficient pointer is managed by the slot and its reference counts are not used.
+ * @param p_filt pointer to the shared filter object
+ * @param p_slot pointer to the coefficient slot
+ * @param value the new measurement or value
+ * @return The newly filtered value
+ */
+float Filter_Slot_Value( Filter_Shared_t* p_filt, Filter_Coeff_Slot_t* p_slot, float value );
+
+#endif
@@ -0,0 +1,147 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Filter_Pipeline.h"
+
+#include <string.h>  // for memcpy
+
+#if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#    error "Filter_Pipeline_Decode copies little-endian floats directly"
+#endif
+
+/**
+ * Function Filter_Pipeline_Init connects the rings and filter of a pipeline.
+ * @param p_pipe pointer to the pipeline
+ * @param p_bytes ring receiving raw bytes
+ * @param p_samples ring between the decoder and the filter
+ * @param p_filt filter applied to every sample
+ * @param p_output ring receiving filtered samples
+ */
+void Filter_Pipeline_Init( Filter_Pipeline_t* p_pipe, Ring_Buffer_Byte_t* p_bytes, Ring_Buffer_Float_t* p_samples, Filter_Data_t* p_filt,
+                           Ring_Buffer_Float_t* p_output )
+{
+    p_pipe->p_bytes   = p_bytes;
+    p_pipe->p_samples = p_samples;
+    p_pipe->p_filt    = p_filt;
+    p_pipe->p_output  = p_output;
+    p_pipe->decoded   = 0;
+    p_pipe->filtered  = 0;
+}
+
+/**
+ * Function Filter_Pipeline_Decode moves every complete float from the byte ring into the sample ring that fits.
+ * @param p_pipe pointer to the pipeline
+ * @return The number of samples decoded
+ */
+uint16_t Filter_Pipeline_Decode( Filter_Pipeline_t* p_pipe )
+{
+    uint16_t total = 0;
+
+    while( rb_length_B( p_pipe->p_bytes ) >= sizeof( float ) ) {
+        float* p_dst;
+        uint8_t space = rb_write_span_F( p_pipe->p_samples, &p_dst );
+        if( space == 0 )
+            break;
+
+        const uint8_t* p_src;
+        uint8_t avail = rb_read_span_B( p_pipe->p_bytes, &p_src ) / sizeof( float );
+
+        if( avail == 0 ) {
+            // this float straddles the wrap point of the byte ring
+            uint8_t raw[sizeof( float )];
+            for( uint8_t i = 0; i < sizeof( float ); i++ )
+                raw[i] = rb_pop_front_B( p_pipe->p_bytes );
+            memcpy( p_dst, raw, sizeof( float ) );
+            avail = 1;
+        } else {
+            if( avail > space )
+                avail = space;
+            // the targets are little-endian, so decoding is a copy
+            memcpy( p_dst, p_src, avail * sizeof( float ) );
+            rb_consume_B( p_pipe->p_bytes, avail * sizeof( float ) );
+        }
+
+        rb_commit_F( p_pipe->p_samples, avail );
+        total += avail;
+    }
+
+    p_pipe->decoded += total;
+    return total;
+}
+
+/**
+ * Function Filter_Pipeline_Filter filters every sample in the sample ring that fits in the output ring.
+ * @param p_pipe pointer to the pipeline
+ * @return The number of samples filtered
+ */
+uint16_t Filter_Pipeline_Filter( Filter_Pipeline_t* p_pipe )
+{
+    uint16_t total = 0;
+
+    for( ;; ) {
+        const float* p_src;
+        float* p_dst;
+        uint8_t avail = rb_read_span_F( p_pipe->p_samples, &p_src );
+        uint8_t space = rb_write_span_F( p_pipe->p_output, &p_dst );
+        uint8_t count = ( avail < space ) ? avail : space;
+        if( count == 0 )
+            break;
+
+        Filter_Value_Block( p_pipe->p_filt, p_src, p_dst, count );
+
+        rb_consume_F( p_pipe->p_samples, count );
+        rb_commit_F( p_pipe->p_output, count );
+        total += count;
+    }
+
+    p_pipe->filtered += total;
+    return total;
+}
+
+/**
+ * Function Filter_Pipeline_Run runs the stages in batches until no stage can make progress.
+ * @param p_pipe pointer to the pipeline
+ * @return The number of samples added to the output ring
+ */
+uint16_t Filter_Pipeline_Run( Filter_Pipeline_t* p_pipe )
+{
+    uint16_t total = 0;
+    uint16_t moved;
+
+    // the sample ring may be smaller than what is waiting in the byte ring, so alternate until neither stage moves
+    do {
+        moved = Filter_Pipeline_Decode( p_pipe );
+        uint16_t filtered = Filter_Pipeline_Filter( p_pipe );
+        moved += filtered;
+        total += filtered;
+    } while( moved > 0 );
+
+    return total;
+}
@@ -0,0 +1,93 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/**
+ * Filter_Pipeline.h/c chains the ingest path
+ *
+ *  Ring_Buffer_Byte_t --decode--> Ring_Buffer_Float_t --filter--> Ring_Buffer_Float_t
+ *
+ * without per-element ring calls. Each stage takes the contiguous span at the start of its input ring and the
+ * contiguous free span at the end of its output ring and processes as much as fits in one batch: the decoder copies
+ * raw little-endian float32 bytes straight into the sample ring's storage and the filter runs Filter_Value_Block from
+ * one ring's storage into the other's. Stages repeat until the input is drained or the output is full, so a full
+ * output ring applies back-pressure instead of overwriting samples.
+ *
+ * The only element-wise path left is a float split across the wrap point of the byte ring, which is assembled a byte
+ * at a time.
+ */
+#ifndef _MEGN540_FILTER_PIPELINE_H
+#define _MEGN540_FILTER_PIPELINE_H
+
+#include "Filter.h"
+
+typedef struct {
+    Ring_Buffer_Byte_t* p_bytes;    // raw little-endian float32 samples
+    Ring_Buffer_Float_t* p_samples;  // decoded samples
+    Filter_Data_t* p_filt;
+    Ring_Buffer_Float_t* p_output;   // filtered samples
+    uint32_t decoded;
+    uint32_t filtered;
+} Filter_Pipeline_t;
+
+/**
+ * Function Filter_Pipeline_Init connects the rings and filter of a pipeline. The rings and filter must already be
+ * initialized.
+ * @param p_pipe pointer to the pipeline
+ * @param p_bytes ring receiving raw bytes
+ * @param p_samples ring between the decoder and the filter
+ * @param p_filt filter applied to every sample
+ * @param p_output ring receiving filtered samples
+ */
+void Filter_Pipeline_Init( Filter_Pipeline_t* p_pipe, Ring_Buffer_Byte_t* p_bytes, Ring_Buffer_Float_t* p_samples, Filter_Data_t* p_filt,
+                           Ring_Buffer_Float_t* p_output );
+
+/**
+ * Function Filter_Pipeline_Decode moves every complete float from the byte ring into the sample ring that fits.
+ * @param p_pipe pointer to the pipeline
+ * @return The number of samples decoded
+ */
+uint16_t Filter_Pipeline_Decode( Filter_Pipeline_t* p_pipe );
+
+/**
+ * Function Filter_Pipeline_Filter filters every sample in the sample ring that fits in the output ring.
+ * @param p_pipe pointer to the pipeline
+ * @return The number of samples filtered
+ */
+uint16_t Filter_Pipeline_Filter( Filter_Pipeline_t* p_pipe );
+
+/**
+ * Function Filter_Pipeline_Run runs the stages in batches until no stage can make progress, i.e. the bytes are
+ * drained or the output ring is full.
+ * @param p_pipe pointer to the pipeline
+ * @return The number of samples added to the output ring
+ */
+uint16_t Filter_Pipeline_Run( Filter_Pipeline_t* p_pipe );
+
+#endif
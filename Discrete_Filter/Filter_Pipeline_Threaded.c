@@ -0,0 +1,295 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#define _GNU_SOURCE  // for pthread_setaffinity_np
+
+#include "Filter_Pipeline_Threaded.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#    error "the decode stage of Filter_Threaded_Run copies little-endian floats directly"
+#endif
+
+static uint64_t now_ns( void )
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+static void pin( int cpu )
+{
+    if( cpu < 0 )
+        return;
+
+    cpu_set_t set;
+    CPU_ZERO( &set );
+    CPU_SET( cpu, &set );
+    pthread_setaffinity_np( pthread_self(), sizeof( set ), &set );
+}
+
+static void* decode_stage( void* p_arg )
+{
+    Filter_Threaded_Pipeline_t* p_pipe = (Filter_Threaded_Pipeline_t*)p_arg;
+    size_t capacity                    = p_pipe->batch * sizeof( float );
+    uint8_t* p_bytes                   = p_pipe->p_scratch;
+    size_t carry                       = 0;  // bytes of an incomplete float kept from the last read
+    uint64_t seq                       = 0;
+
+    pin( p_pipe->cpu[0] );
+
+    for( ;; ) {
+        size_t got = p_pipe->source( p_pipe->p_source_context, p_bytes + carry, capacity - carry );
+        if( got == 0 )
+            break;
+
+        size_t total = carry + got;
+        size_t count = total / sizeof( float );
+
+        if( count > 0 && atomic_load_explicit( &p_pipe->marker_seq, memory_order_acquire ) == 0 ) {
+            p_pipe->marker_time_ns = now_ns();
+            atomic_store_explicit( &p_pipe->marker_seq, seq + 1, memory_order_release );
+        }
+
+        const uint8_t* p_src = p_bytes;
+        size_t left          = count;
+        while( left > 0 ) {
+            float* p_dst;
+            uint32_t span = rb_spsc_write_span_F( &p_pipe->decoded, &p_dst );
+            if( span == 0 ) {
+                p_pipe->stats.decode_stalls++;
+                sched_yield();
+                continue;
+            }
+            if( span > left )
+                span = left;
+
+            // the targets are little-endian, so decoding is a copy
+            memcpy( p_dst, p_src, span * sizeof( float ) );
+            rb_spsc_commit_F( &p_pipe->decoded, span );
+            p_src += span * sizeof( float );
+            left -= span;
+        }
+        seq += count;
+
+        carry = total - count * sizeof( float );
+        memmove( p_bytes, p_bytes + count * sizeof( float ), carry );
+    }
+
+    atomic_store_explicit( &p_pipe->decode_done, true, memory_order_release );
+    return NULL;
+}
+
+static void* filter_stage( void* p_arg )
+{
+    Filter_Threaded_Pipeline_t* p_pipe = (Filter_Threaded_Pipeline_t*)p_arg;
+
+    pin( p_pipe->cpu[1] );
+
+    for( ;; ) {
+        // read the flag before the ring so a set flag guarantees the final samples are visible
+        bool done = atomic_load_explicit( &p_pipe->decode_done, memory_order_acquire );
+
+        const float* p_src;
+        uint32_t avail = rb_spsc_read_span_F( &p_pipe->decoded, &p_src );
+        if( avail == 0 ) {
+            if( done )
+                break;
+            sched_yield();
+            continue;
+        }
+
+        float* p_dst;
+        uint32_t space = rb_spsc_write_span_F( &p_pipe->filtered, &p_dst );
+        if( space == 0 ) {
+            p_pipe->stats.filter_stalls++;
+            sched_yield();
+            continue;
+        }
+
+        uint32_t count = ( avail < space ) ? avail : space;
+        if( count > p_pipe->batch )
+            count = p_pipe->batch;
+
+        Filter_Value_Block( p_pipe->p_filt, p_src, p_dst, count );
+        rb_spsc_consume_F( &p_pipe->decoded, count );
+        rb_spsc_commit_F( &p_pipe->filtered, count );
+    }
+
+    atomic_store_explicit( &p_pipe->filter_done, true, memory_order_release );
+    return NULL;
+}
+
+static void* sink_stage( void* p_arg )
+{
+    Filter_Threaded_Pipeline_t* p_pipe = (Filter_Threaded_Pipeline_t*)p_arg;
+    Filter_Threaded_Stats_t* p_stats   = &p_pipe->stats;
+    uint64_t latency_total             = 0;
+
+    pin( p_pipe->cpu[2] );
+
+    for( ;; ) {
+        bool done = atomic_load_explicit( &p_pipe->filter_done, memory_order_acquire );
+
+        const float* p_src;
+        uint32_t count = rb_spsc_read_span_F( &p_pipe->filtered, &p_src );
+        if( count == 0 ) {
+            if( done )
+                break;
+            sched_yield();
+            continue;
+        }
+        if( count > p_pipe->batch )
+            count = p_pipe->batch;
+
+        p_pipe->sink( p_pipe->p_sink_context, p_src, count );
+        rb_spsc_consume_F( &p_pipe->filtered, count );
+        p_stats->samples += count;
+
+        // the marked sample has been delivered once the count passes its sequence number
+        uint64_t marker = atomic_load_explicit( &p_pipe->marker_seq, memory_order_acquire );
+        if( marker != 0 && p_stats->samples >= marker ) {
+            uint64_t latency = now_ns() - p_pipe->marker_time_ns;
+            if( p_stats->latency_count == 0 || latency < p_stats->latency_min_ns )
+                p_stats->latency_min_ns = latency;
+            if( latency > p_stats->latency_max_ns )
+                p_stats->latency_max_ns = latency;
+            latency_total += latency;
+            p_stats->latency_count++;
+            atomic_store_explicit( &p_pipe->marker_seq, 0, memory_order_release );
+        }
+    }
+
+    if( p_stats->latency_count > 0 )
+        p_stats->latency_mean_ns = latency_total / p_stats->latency_count;
+
+    return NULL;
+}
+
+/**
+ * Function Filter_Threaded_Init sets up a threaded pipeline.
+ * @param p_pipe pointer to the pipeline
+ * @param source callback delivering raw bytes
+ * @param p_source_context argument passed to source
+ * @param p_filt filter applied to every sample
+ * @param sink callback receiving filtered samples
+ * @param p_sink_context argument passed to sink
+ * @param batch maximum samples each stage moves per step, 0 for RB_LENGTH_SPSC / 4
+ */
+void Filter_Threaded_Init( Filter_Threaded_Pipeline_t* p_pipe, Filter_Source_t source, void* p_source_context, Filter_Data_t* p_filt,
+                           Filter_Sink_t sink, void* p_sink_context, uint32_t batch )
+{
+    p_pipe->source           = source;
+    p_pipe->p_source_context = p_source_context;
+    p_pipe->p_filt           = p_filt;
+    p_pipe->sink             = sink;
+    p_pipe->p_sink_context   = p_sink_context;
+    p_pipe->batch            = ( batch == 0 ) ? RB_LENGTH_SPSC / 4 : batch;
+
+    Filter_Threaded_Pin( p_pipe, -1, -1, -1 );
+}
+
+/**
+ * Function Filter_Threaded_Pin selects the CPU each stage thread runs on.
+ * @param p_pipe pointer to the pipeline
+ * @param decode_cpu CPU for the decode stage, -1 for any
+ * @param filter_cpu CPU for the filter stage, -1 for any
+ * @param sink_cpu CPU for the sink stage, -1 for any
+ */
+void Filter_Threaded_Pin( Filter_Threaded_Pipeline_t* p_pipe, int decode_cpu, int filter_cpu, int sink_cpu )
+{
+    p_pipe->cpu[0] = decode_cpu;
+    p_pipe->cpu[1] = filter_cpu;
+    p_pipe->cpu[2] = sink_cpu;
+}
+
+/**
+ * Function Filter_Threaded_Run runs the pipeline until the source reports end of stream and every sample has reached
+ * the sink.
+ * @param p_pipe pointer to the pipeline
+ * @param p_stats optional destination for throughput and latency measurements, may be NULL
+ * @return true on success, false if the decode buffer could not be allocated or the stage threads could not be started
+ */
+bool Filter_Threaded_Run( Filter_Threaded_Pipeline_t* p_pipe, Filter_Threaded_Stats_t* p_stats )
+{
+    void* ( *stages[3] )( void* ) = { decode_stage, filter_stage, sink_stage };
+    pthread_t threads[3];
+    int started = 0;
+
+    // allocated here rather than in the decode thread so a failure is reported instead of looking like end of stream
+    p_pipe->p_scratch = malloc( p_pipe->batch * sizeof( float ) );
+    if( p_pipe->p_scratch == NULL )
+        return false;
+
+    rb_spsc_initialize_F( &p_pipe->decoded );
+    rb_spsc_initialize_F( &p_pipe->filtered );
+    atomic_init( &p_pipe->decode_done, false );
+    atomic_init( &p_pipe->filter_done, false );
+    atomic_init( &p_pipe->marker_seq, 0 );
+    memset( &p_pipe->stats, 0, sizeof( p_pipe->stats ) );
+
+    uint64_t start = now_ns();
+
+    // start from the sink so nothing waits on a stage that does not exist yet
+    for( int s = 2; s >= 0; s-- ) {
+        if( pthread_create( &threads[s], NULL, stages[s], p_pipe ) != 0 )
+            break;
+        started++;
+    }
+
+    if( started < 3 ) {
+        // unblock and collect whatever did start
+        atomic_store( &p_pipe->decode_done, true );
+        atomic_store( &p_pipe->filter_done, true );
+        for( int s = 2; s > 2 - started; s-- )
+            pthread_join( threads[s], NULL );
+        free( p_pipe->p_scratch );
+        p_pipe->p_scratch = NULL;
+        return false;
+    }
+
+    for( int s = 0; s < 3; s++ )
+        pthread_join( threads[s], NULL );
+    free( p_pipe->p_scratch );
+    p_pipe->p_scratch = NULL;
+
+    p_pipe->stats.seconds            = ( now_ns() - start ) * 1e-9;
+    p_pipe->stats.samples_per_second = p_pipe->stats.samples / p_pipe->stats.seconds;
+
+    if( p_stats != NULL )
+        *p_stats = p_pipe->stats;
+
+    return true;
+}
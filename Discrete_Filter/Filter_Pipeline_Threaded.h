@@ -0,0 +1,124 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/**
+ * Filter_Pipeline_Threaded.h/c runs the ingest path of Filter_Pipeline.h with each stage on its own thread:
+ *
+ *  source --decode thread--> SPSC ring --filter thread--> SPSC ring --sink thread--> sink
+ *
+ * The source callback delivers raw little-endian float32 bytes (a serial port, socket, file...) and the sink callback
+ * receives filtered samples for encoding or logging. Stages are connected by Ring_Buffer_SPSC_Float_t, move at most
+ * batch samples per step, and wait by yielding when their input is empty or their output is full, so a slow stage
+ * holds back the ones before it instead of losing data. Each stage can be pinned to a CPU.
+ *
+ * Filter_Threaded_Run reports throughput and end-to-end latency. Latency is sampled: whenever no measurement is in
+ * flight the decode thread timestamps the first sample of a batch, and the sink thread takes the difference when that
+ * sample reaches the sink.
+ *
+ * Linux only; not built for AVR_MCU.
+ */
+#ifndef _MEGN540_FILTER_PIPELINE_THREADED_H
+#define _MEGN540_FILTER_PIPELINE_THREADED_H
+
+#include "Filter.h"
+#include "Ring_Buffer_SPSC.h"
+
+#include <stddef.h>
+
+// returns the number of bytes written to p_bytes, 0 at end of stream
+typedef size_t ( *Filter_Source_t )( void* p_context, uint8_t* p_bytes, size_t capacity );
+// receives count filtered samples
+typedef void ( *Filter_Sink_t )( void* p_context, const float* p_samples, size_t count );
+
+typedef struct {
+    uint64_t samples;
+    double seconds;
+    double samples_per_second;
+    uint64_t latency_count;  // number of latency measurements
+    uint64_t latency_min_ns;
+    uint64_t latency_mean_ns;
+    uint64_t latency_max_ns;
+    uint64_t decode_stalls;  // times the decode stage waited on a full ring
+    uint64_t filter_stalls;  // times the filter stage waited on a full ring
+} Filter_Threaded_Stats_t;
+
+typedef struct {
+    Filter_Source_t source;
+    void* p_source_context;
+    Filter_Data_t* p_filt;
+    Filter_Sink_t sink;
+    void* p_sink_context;
+    uint32_t batch;
+    int cpu[3];  // decode, filter and sink CPUs, -1 to leave unpinned
+
+    uint8_t* p_scratch;  // batch floats of raw bytes for the decode stage, allocated by Filter_Threaded_Run
+    Ring_Buffer_SPSC_Float_t decoded;
+    Ring_Buffer_SPSC_Float_t filtered;
+
+    atomic_bool decode_done;
+    atomic_bool filter_done;
+    _Atomic uint64_t marker_seq;  // sequence number + 1 of the timestamped sample, 0 when none is in flight
+    uint64_t marker_time_ns;
+    Filter_Threaded_Stats_t stats;
+} Filter_Threaded_Pipeline_t;
+
+/**
+ * Function Filter_Threaded_Init sets up a threaded pipeline. The filter must already be initialized and is only used
+ * by the filter thread while the pipeline runs.
+ * @param p_pipe pointer to the pipeline
+ * @param source callback delivering raw bytes
+ * @param p_source_context argument passed to source
+ * @param p_filt filter applied to every sample
+ * @param sink callback receiving filtered samples
+ * @param p_sink_context argument passed to sink
+ * @param batch maximum samples each stage moves per step, 0 for RB_LENGTH_SPSC / 4
+ */
+void Filter_Threaded_Init( Filter_Threaded_Pipeline_t* p_pipe, Filter_Source_t source, void* p_source_context, Filter_Data_t* p_filt,
+                           Filter_Sink_t sink, void* p_sink_context, uint32_t batch );
+
+/**
+ * Function Filter_Threaded_Pin selects the CPU each stage thread runs on.
+ * @param p_pipe pointer to the pipeline
+ * @param decode_cpu CPU for the decode stage, -1 for any
+ * @param filter_cpu CPU for the filter stage, -1 for any
+ * @param sink_cpu CPU for the sink stage, -1 for any
+ */
+void Filter_Threaded_Pin( Filter_Threaded_Pipeline_t* p_pipe, int decode_cpu, int filter_cpu, int sink_cpu );
+
+/**
+ * Function Filter_Threaded_Run runs the pipeline until the source reports end of stream and every sample has reached
+ * the sink.
+ * @param p_pipe pointer to the pipeline
+ * @param p_stats optional destination for throughput and latency measurements, may be NULL
+ * @return true on success, false if the decode buffer could not be allocated or the stage threads could not be started
+ */
+bool Filter_Threaded_Run( Filter_Threaded_Pipeline_t* p_pipe, Filter_Threaded_Stats_t* p_stats );
+
+#endif
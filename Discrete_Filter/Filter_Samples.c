@@ -0,0 +1,227 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Filter_Samples.h"
+
+#include <fcntl.h>
+#include <stdlib.h>  // for strtof
+#include <string.h>  // for memcmp and strlen
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SAMPLES_GATHER_BLOCK 1024
+#define SAMPLES_CSV_LINE     4096
+
+_Static_assert( sizeof( Filter_Samples_Header_t ) == 32, "the header layout is part of the file format" );
+
+bool Filter_Samples_Create( Filter_Samples_Writer_t* p_writer, const char* path, uint16_t channel_count, float sample_rate )
+{
+    if( channel_count == 0 )
+        return false;
+
+    memset( &p_writer->header, 0, sizeof( p_writer->header ) );
+    memcpy( p_writer->header.magic, "FSMP", 4 );
+    p_writer->header.version       = FILTER_SAMPLES_VERSION;
+    p_writer->header.sample_type   = FILTER_SAMPLES_FLOAT32;
+    p_writer->header.channel_count = channel_count;
+    p_writer->header.sample_rate   = sample_rate;
+    p_writer->sample_count         = 0;
+
+    p_writer->p_file = fopen( path, "wb" );
+    if( p_writer->p_file == NULL )
+        return false;
+
+    if( fwrite( &p_writer->header, sizeof( p_writer->header ), 1, p_writer->p_file ) != 1 ) {
+        fclose( p_writer->p_file );
+        return false;
+    }
+    return true;
+}
+
+bool Filter_Samples_Write( Filter_Samples_Writer_t* p_writer, const float* p_data, size_t count )
+{
+    size_t written = fwrite( p_data, sizeof( float ), count, p_writer->p_file );
+    p_writer->sample_count += written;
+    return written == count;
+}
+
+bool Filter_Samples_Write_Ring( Filter_Samples_Writer_t* p_writer, Ring_Buffer_Float_t* p_buf )
+{
+    const float* p_data;
+    uint8_t span;
+
+    // at most two spans, one either side of the wrap point
+    while( ( span = rb_read_span_F( p_buf, &p_data ) ) > 0 ) {
+        if( !Filter_Samples_Write( p_writer, p_data, span ) )
+            return false;
+        rb_consume_F( p_buf, span );
+    }
+    return true;
+}
+
+bool Filter_Samples_Close( Filter_Samples_Writer_t* p_writer )
+{
+    p_writer->header.frame_count = p_writer->sample_count / p_writer->header.channel_count;
+
+    bool ok = fseek( p_writer->p_file, 0, SEEK_SET ) == 0 && fwrite( &p_writer->header, sizeof( p_writer->header ), 1, p_writer->p_file ) == 1;
+    ok      = ( fclose( p_writer->p_file ) == 0 ) && ok;
+
+    p_writer->p_file = NULL;
+    return ok;
+}
+
+bool Filter_Samples_Open( Filter_Samples_Reader_t* p_reader, const char* path )
+{
+    int fd = open( path, O_RDONLY );
+    if( fd < 0 )
+        return false;
+
+    struct stat info;
+    void* p_map = MAP_FAILED;
+    if( fstat( fd, &info ) == 0 && (size_t)info.st_size >= sizeof( Filter_Samples_Header_t ) )
+        p_map = mmap( NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if( p_map == MAP_FAILED )
+        return false;
+
+    const Filter_Samples_Header_t* p_header = p_map;
+    if( memcmp( p_header->magic, "FSMP", 4 ) != 0 || p_header->version != FILTER_SAMPLES_VERSION || p_header->sample_type != FILTER_SAMPLES_FLOAT32
+        || p_header->channel_count == 0 ) {
+        munmap( p_map, (size_t)info.st_size );
+        return false;
+    }
+
+    // the data actually present bounds the header's count, and stands in for it if the writer never closed the file
+    uint64_t frames_present = ( (size_t)info.st_size - sizeof( *p_header ) ) / ( sizeof( float ) * p_header->channel_count );
+
+    p_reader->p_header      = p_header;
+    p_reader->p_samples     = (const float*)( p_header + 1 );
+    p_reader->channel_count = p_header->channel_count;
+    p_reader->frame_count   = ( p_header->frame_count != 0 && p_header->frame_count < frames_present ) ? p_header->frame_count : frames_present;
+    p_reader->map_size      = (size_t)info.st_size;
+
+    // filtering walks the file once, front to back
+    madvise( p_map, p_reader->map_size, MADV_SEQUENTIAL );
+    return true;
+}
+
+bool Filter_Samples_Filter( const Filter_Samples_Reader_t* p_reader, uint16_t channel, Filter_Data_t* p_filt, float* p_out )
+{
+    if( channel >= p_reader->channel_count )
+        return false;
+
+    if( p_reader->channel_count == 1 ) {
+        Filter_Value_Block( p_filt, p_reader->p_samples, p_out, p_reader->frame_count );
+        return true;
+    }
+
+    float block[SAMPLES_GATHER_BLOCK];
+    const float* p_in = p_reader->p_samples + channel;
+
+    for( uint64_t done = 0; done < p_reader->frame_count; ) {
+        size_t count = ( p_reader->frame_count - done < SAMPLES_GATHER_BLOCK ) ? p_reader->frame_count - done : SAMPLES_GATHER_BLOCK;
+        for( size_t i = 0; i < count; i++, p_in += p_reader->channel_count )
+            block[i] = *p_in;
+
+        Filter_Value_Block( p_filt, block, p_out + done, count );
+        done += count;
+    }
+    return true;
+}
+
+void Filter_Samples_Release( Filter_Samples_Reader_t* p_reader )
+{
+    munmap( (void*)p_reader->p_header, p_reader->map_size );
+    p_reader->p_header  = NULL;
+    p_reader->p_samples = NULL;
+}
+
+// parses the values on one line, returns how many, or 0 if the line does not start with a number
+static size_t samples_parse_line( const char* p_line, float* p_values, size_t capacity )
+{
+    size_t count = 0;
+    char* p_end;
+
+    while( count < capacity ) {
+        float value = strtof( p_line, &p_end );
+        if( p_end == p_line )
+            break;
+
+        p_values[count++] = value;
+        p_line            = p_end + strspn( p_end, ", \t\r\n" );
+    }
+    return count;
+}
+
+long Filter_Samples_From_CSV( const char* csv_path, const char* path, float sample_rate )
+{
+    FILE* p_csv = fopen( csv_path, "r" );
+    if( p_csv == NULL )
+        return -1;
+
+    char line[SAMPLES_CSV_LINE];
+    float values[SAMPLES_CSV_LINE / 2];  // a value takes at least a digit and a separator
+    Filter_Samples_Writer_t writer;
+    size_t channels = 0;
+    long frames     = 0;
+    bool ok         = true;
+
+    while( ok && fgets( line, sizeof( line ), p_csv ) != NULL ) {
+        // a line that filled the buffer without its newline was split, unless it is the last line of the file
+        size_t length = strlen( line );
+        if( length == sizeof( line ) - 1 && line[length - 1] != '\n' ) {
+            int next = fgetc( p_csv );
+            if( next != EOF ) {
+                ok = false;
+                break;
+            }
+        }
+
+        size_t count = samples_parse_line( line, values, sizeof( values ) / sizeof( values[0] ) );
+        if( count == 0 )
+            continue;
+
+        if( channels == 0 ) {
+            if( count > UINT16_MAX || !Filter_Samples_Create( &writer, path, (uint16_t)count, sample_rate ) )
+                break;
+            channels = count;
+        }
+
+        ok = ( count == channels ) && Filter_Samples_Write( &writer, values, count );
+        frames++;
+    }
+
+    fclose( p_csv );
+    if( channels == 0 )
+        return -1;
+    ok = Filter_Samples_Close( &writer ) && ok;
+    return ok ? frames : -1;
+}
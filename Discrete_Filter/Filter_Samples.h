@@ -0,0 +1,167 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/**
+ * Filter_Samples.h/c reads and writes recorded samples in a small binary format so offline analysis can skip text
+ * parsing and feed the data straight to Filter_Value_Block.
+ *
+ * A sample file is a 32 byte header followed by the samples, interleaved by channel, as little-endian 32 bit floats:
+ *
+ *  byte 0-3    'F' 'S' 'M' 'P'  magic
+ *  byte 4      version (FILTER_SAMPLES_VERSION)
+ *  byte 5      sample type (FILTER_SAMPLES_FLOAT32)
+ *  byte 6-7    channel count
+ *  byte 8-11   sample rate in Hz, float
+ *  byte 16-23  frame count, one sample of every channel per frame
+ *
+ * The writer leaves the frame count at 0 until Filter_Samples_Close, and the reader then takes it from the file size,
+ * so a recording cut short by a crash is still readable. The reader maps the file, so a single channel file is handed
+ * to the filter without any copy and files larger than memory are paged in as they are filtered.
+ *
+ * Filter_Samples_From_CSV converts comma or whitespace separated text, one frame per line, to this format.
+ *
+ * Not built for AVR_MCU.
+ */
+#ifndef _MEGN540_FILTER_SAMPLES_H
+#define _MEGN540_FILTER_SAMPLES_H
+
+#include "Filter.h"
+#include "Ring_Buffer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#    error "Filter_Samples writes samples in native byte order, which must be little-endian"
+#endif
+
+#define FILTER_SAMPLES_VERSION 1
+#define FILTER_SAMPLES_FLOAT32 1
+
+typedef struct {
+    char magic[4];
+    uint8_t version;
+    uint8_t sample_type;
+    uint16_t channel_count;
+    float sample_rate;
+    uint32_t reserved;
+    uint64_t frame_count;
+    uint64_t reserved_2;
+} Filter_Samples_Header_t;
+
+typedef struct {
+    FILE* p_file;
+    Filter_Samples_Header_t header;
+    uint64_t sample_count;  // samples written so far, frame_count is this over channel_count
+} Filter_Samples_Writer_t;
+
+typedef struct {
+    const Filter_Samples_Header_t* p_header;
+    const float* p_samples;  // interleaved frames
+    uint64_t frame_count;
+    uint16_t channel_count;
+    size_t map_size;
+} Filter_Samples_Reader_t;
+
+/**
+ * Function Filter_Samples_Create creates a sample file and writes its header.
+ * @param p_writer pointer to the writer object
+ * @param path file to create or truncate
+ * @param channel_count samples per frame
+ * @param sample_rate sample rate in Hz, stored for the reader
+ * @return true if the file was created
+ */
+bool Filter_Samples_Create( Filter_Samples_Writer_t* p_writer, const char* path, uint16_t channel_count, float sample_rate );
+
+/**
+ * Function Filter_Samples_Write appends interleaved samples.
+ * @param p_writer pointer to the writer object
+ * @param p_data samples, channel_count per frame
+ * @param count number of samples, not frames
+ * @return true if all samples were written
+ */
+bool Filter_Samples_Write( Filter_Samples_Writer_t* p_writer, const float* p_data, size_t count );
+
+/**
+ * Function Filter_Samples_Write_Ring drains a float ring buffer into the file, span by span.
+ * @param p_writer pointer to the writer object
+ * @param p_buf ring buffer holding interleaved samples, empty on return if the write succeeded
+ * @return true if all samples were written
+ */
+bool Filter_Samples_Write_Ring( Filter_Samples_Writer_t* p_writer, Ring_Buffer_Float_t* p_buf );
+
+/**
+ * Function Filter_Samples_Close stores the frame count in the header and closes the file.
+ * @param p_writer pointer to the writer object
+ * @return true if the file was completed
+ */
+bool Filter_Samples_Close( Filter_Samples_Writer_t* p_writer );
+
+/**
+ * Function Filter_Samples_Open maps a sample file for reading.
+ * @param p_reader pointer to the reader object
+ * @param path file to open
+ * @return true if the file is a valid sample file
+ */
+bool Filter_Samples_Open( Filter_Samples_Reader_t* p_reader, const char* path );
+
+/**
+ * Function Filter_Samples_Filter runs one channel of the file through a filter with Filter_Value_Block. A single
+ * channel file is filtered straight from the mapping, other channels are gathered a block at a time.
+ * @param p_reader pointer to the reader object
+ * @param channel channel to filter
+ * @param p_filt pointer to the filter object
+ * @param p_out destination for frame_count filtered values
+ * @return false, without filtering, if channel is not below the file's channel count
+ */
+bool Filter_Samples_Filter( const Filter_Samples_Reader_t* p_reader, uint16_t channel, Filter_Data_t* p_filt, float* p_out );
+
+/**
+ * Function Filter_Samples_Release unmaps a sample file.
+ * @param p_reader pointer to the reader object
+ */
+void Filter_Samples_Release( Filter_Samples_Reader_t* p_reader );
+
+/**
+ * Function Filter_Samples_From_CSV converts a text file with one frame per line to a sample file. Lines that do not
+ * start with a number, such as a column header, are skipped. The first numeric line sets the channel count. Lines
+ * may be up to 4095 characters; a longer line is an error rather than being split into two frames.
+ * @param csv_path text file to read
+ * @param path sample file to write
+ * @param sample_rate sample rate in Hz to store
+ * @return The number of frames converted, -1 on an I/O error, a line that is too long, a line with the wrong number
+ *         of values, or a file without any numeric line (there is no channel count to write), in which case no
+ *         sample file is created
+ */
+long Filter_Samples_From_CSV( const char* csv_path, const char* path, float sample_rate );
+
+#endif
@@ -0,0 +1,266 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Filter_Scheduler.h"
+
+#ifndef AVR_MCU
+#    include <time.h>
+#endif
+
+static uint16_t gcd( uint16_t a, uint16_t b )
+{
+    while( b != 0 ) {
+        uint16_t r = a % b;
+        a          = b;
+        b          = r;
+    }
+    return a;
+}
+
+// Picks the phase for a new task that shares ticks with the fewest existing tasks. Two tasks with divisors D1, D2 and
+// phases p1, p2 coincide on some tick exactly when p1 and p2 are congruent modulo gcd( D1, D2 ).
+static uint16_t pick_phase( const Filter_Scheduler_t* p_sched, uint16_t divisor )
+{
+    uint16_t best_phase = 0;
+    uint16_t best_cost  = UINT16_MAX;
+
+    for( uint16_t phase = 0; phase < divisor && best_cost > 0; phase++ ) {
+        uint16_t cost = 0;
+        for( uint8_t i = 0; i < p_sched->task_count; i++ ) {
+            const Filter_Sched_Task_t* p_task = &p_sched->tasks[i];
+            uint16_t g                        = gcd( divisor, p_task->divisor );
+            cost += ( phase % g ) == ( p_task->phase % g );
+        }
+        if( cost < best_cost ) {
+            best_cost  = cost;
+            best_phase = phase;
+        }
+    }
+
+    return best_phase;
+}
+
+// Makes sure a group exists for the divisor, keeping groups sorted by divisor.
+static bool add_group( Filter_Scheduler_t* p_sched, uint16_t divisor )
+{
+    uint8_t g = 0;
+    while( g < p_sched->group_count && p_sched->groups[g].divisor < divisor )
+        g++;
+
+    if( g < p_sched->group_count && p_sched->groups[g].divisor == divisor )
+        return true;
+    if( p_sched->group_count == FILTER_SCHED_MAX_GROUPS )
+        return false;
+
+    for( uint8_t i = p_sched->group_count; i > g; i-- )
+        p_sched->groups[i] = p_sched->groups[i - 1];
+
+    // start the counter in step with the global tick so phases mean the same thing in every group
+    p_sched->groups[g].divisor = divisor;
+    p_sched->groups[g].counter = p_sched->tick % divisor;
+    p_sched->group_count++;
+
+    return true;
+}
+
+// Recomputes each group's task range and cursor after the table changed.
+static void index_groups( Filter_Scheduler_t* p_sched )
+{
+    uint8_t t = 0;
+    for( uint8_t g = 0; g < p_sched->group_count; g++ ) {
+        Filter_Sched_Group_t* p_group = &p_sched->groups[g];
+
+        p_group->first = t;
+        while( t < p_sched->task_count && p_sched->tasks[t].divisor == p_group->divisor )
+            t++;
+        p_group->end = t;
+
+        p_group->next = p_group->first;
+        while( p_group->next < p_group->end && p_sched->tasks[p_group->next].phase < p_group->counter )
+            p_group->next++;
+    }
+}
+
+// Inserts a task keeping the table sorted by divisor then phase.
+static bool add_task( Filter_Scheduler_t* p_sched, Filter_Sched_Task_t* p_task )
+{
+    if( p_task->divisor == 0 || p_sched->task_count == FILTER_SCHED_MAX_TASKS )
+        return false;
+    if( !add_group( p_sched, p_task->divisor ) )
+        return false;
+
+    p_task->phase = pick_phase( p_sched, p_task->divisor );
+
+    uint8_t t = 0;
+    while( t < p_sched->task_count
+           && ( p_sched->tasks[t].divisor < p_task->divisor || ( p_sched->tasks[t].divisor == p_task->divisor && p_sched->tasks[t].phase <= p_task->phase ) ) )
+        t++;
+
+    for( uint8_t i = p_sched->task_count; i > t; i-- )
+        p_sched->tasks[i] = p_sched->tasks[i - 1];
+
+    p_sched->tasks[t] = *p_task;
+    p_sched->task_count++;
+    index_groups( p_sched );
+
+    return true;
+}
+
+/**
+ * Function Filter_Sched_Init clears the task table and statistics.
+ * @param p_sched pointer to the scheduler
+ * @param clock function returning a free running time, NULL to disable timing
+ * @param budget per-tick execution time allowed before a tick counts as an overrun, in clock units
+ */
+void Filter_Sched_Init( Filter_Scheduler_t* p_sched, Filter_Sched_Clock_t clock, uint32_t budget )
+{
+    p_sched->task_count  = 0;
+    p_sched->group_count = 0;
+    p_sched->tick        = 0;
+    p_sched->clock       = clock;
+    p_sched->budget      = budget;
+    Filter_Sched_Reset_Stats( p_sched );
+}
+
+/**
+ * Function Filter_Sched_Add_Filter registers a filter that reads *p_input and writes *p_output when it runs.
+ * @param p_sched pointer to the scheduler
+ * @param p_filt pointer to the filter object
+ * @param p_input value filtered on each run
+ * @param p_output where the filtered value is stored, may be NULL
+ * @param divisor run every divisor ticks
+ * @return true if added, false if the task or group table is full or divisor is 0
+ */
+bool Filter_Sched_Add_Filter( Filter_Scheduler_t* p_sched, Filter_Data_t* p_filt, const float* p_input, float* p_output, uint16_t divisor )
+{
+    Filter_Sched_Task_t task = { NULL, NULL, p_filt, p_input, p_output, divisor, 0 };
+    return add_task( p_sched, &task );
+}
+
+/**
+ * Function Filter_Sched_Add_Callback registers a callback.
+ * @param p_sched pointer to the scheduler
+ * @param callback function to run
+ * @param p_context argument passed to callback
+ * @param divisor run every divisor ticks
+ * @return true if added, false if the task or group table is full or divisor is 0
+ */
+bool Filter_Sched_Add_Callback( Filter_Scheduler_t* p_sched, Filter_Sched_Callback_t callback, void* p_context, uint16_t divisor )
+{
+    Filter_Sched_Task_t task = { callback, p_context, NULL, NULL, NULL, divisor, 0 };
+    return add_task( p_sched, &task );
+}
+
+/**
+ * Function Filter_Sched_Tick runs every task due on the current tick and advances the tick.
+ * @param p_sched pointer to the scheduler
+ */
+void Filter_Sched_Tick( Filter_Scheduler_t* p_sched )
+{
+    uint32_t start = p_sched->clock ? p_sched->clock() : 0;
+
+    // the due tasks of a group are the run at its cursor whose phase equals the counter
+    for( uint8_t g = 0; g < p_sched->group_count; g++ ) {
+        Filter_Sched_Group_t* p_group = &p_sched->groups[g];
+
+        for( ; p_group->next < p_group->end && p_sched->tasks[p_group->next].phase == p_group->counter; p_group->next++ ) {
+            Filter_Sched_Task_t* p_task = &p_sched->tasks[p_group->next];
+
+            if( p_task->callback != NULL ) {
+                p_task->callback( p_task->p_context );
+            } else {
+                float out_val = Filter_Value( p_task->p_filt, *p_task->p_input );
+                if( p_task->p_output != NULL )
+                    *p_task->p_output = out_val;
+            }
+        }
+
+        p_group->counter++;
+        if( p_group->counter == p_group->divisor ) {
+            p_group->counter = 0;
+            p_group->next    = p_group->first;
+        }
+    }
+
+    if( p_sched->clock ) {
+        uint32_t elapsed           = p_sched->clock() - start;
+        Filter_Sched_Stats_t* p_st = &p_sched->stats;
+
+        if( p_st->ticks == 0 || elapsed < p_st->min_time )
+            p_st->min_time = elapsed;
+        if( elapsed > p_st->max_time ) {
+            p_st->max_time = elapsed;
+            p_st->max_tick = p_sched->tick;
+        }
+        if( elapsed > p_sched->budget )
+            p_st->overruns++;
+        p_st->total_time += elapsed;
+        p_st->ticks++;
+    }
+
+    p_sched->tick++;
+}
+
+/**
+ * Function Filter_Sched_Get_Stats copies the per-tick execution time statistics.
+ * @param p_sched pointer to the scheduler
+ * @param p_stats destination for the statistics
+ */
+void Filter_Sched_Get_Stats( const Filter_Scheduler_t* p_sched, Filter_Sched_Stats_t* p_stats )
+{
+    *p_stats = p_sched->stats;
+}
+
+/**
+ * Function Filter_Sched_Reset_Stats restarts the statistics, e.g. after start-up.
+ * @param p_sched pointer to the scheduler
+ */
+void Filter_Sched_Reset_Stats( Filter_Scheduler_t* p_sched )
+{
+    p_sched->stats.ticks      = 0;
+    p_sched->stats.overruns   = 0;
+    p_sched->stats.min_time   = 0;
+    p_sched->stats.max_time   = 0;
+    p_sched->stats.max_tick   = 0;
+    p_sched->stats.total_time = 0;
+}
+
+#ifndef AVR_MCU
+/**
+ * Function Filter_Sched_Clock_Ns is a CLOCK_MONOTONIC based clock in nanoseconds for use with Filter_Sched_Init.
+ * @return The current time, wrapping every ~4.3 s
+ */
+uint32_t Filter_Sched_Clock_Ns( void )
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (uint32_t)( now.tv_sec * 1000000000ull + now.tv_nsec );
+}
+#endif
@@ -0,0 +1,160 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/**
+ * Filter_Scheduler.h/c runs filters (or any callback) at integer divisions of a base tick rate, e.g. a 1 kHz tick with
+ * divisors 1, 10 and 100 for 1 kHz, 100 Hz and 10 Hz work.
+ *
+ * Tasks are kept sorted by divisor and then by phase, so the tasks of a group that are due on a tick form one
+ * contiguous run. Each group keeps a cursor to its next run, and a tick only visits the groups and the due tasks.
+ * When a task is added it is given the phase within its divisor that collides with the fewest existing tasks, so
+ * slower groups are spread across ticks instead of all landing on tick 0.
+ *
+ * If a clock function is given, every tick is timed and the minimum, mean and maximum execution time and the number
+ * of ticks that exceeded the budget are reported by Filter_Sched_Get_Stats. The clock units are up to the caller.
+ *
+ * No dynamic memory is used; the table sizes can be changed with FILTER_SCHED_MAX_TASKS/FILTER_SCHED_MAX_GROUPS.
+ */
+#ifndef _MEGN540_FILTER_SCHEDULER_H
+#define _MEGN540_FILTER_SCHEDULER_H
+
+#include "Filter.h"
+
+#include <stdbool.h>
+
+#ifndef FILTER_SCHED_MAX_TASKS
+#    define FILTER_SCHED_MAX_TASKS 32  // max 255
+#endif
+
+#ifndef FILTER_SCHED_MAX_GROUPS
+#    define FILTER_SCHED_MAX_GROUPS 8  // number of distinct divisors
+#endif
+
+typedef void ( *Filter_Sched_Callback_t )( void* p_context );
+typedef uint32_t ( *Filter_Sched_Clock_t )( void );
+
+// a filter or callback run every divisor ticks, on ticks where tick % divisor == phase
+typedef struct {
+    Filter_Sched_Callback_t callback;  // NULL for a filter task
+    void* p_context;
+    Filter_Data_t* p_filt;
+    const float* p_input;
+    float* p_output;
+    uint16_t divisor;
+    uint16_t phase;
+} Filter_Sched_Task_t;
+
+// all tasks sharing a divisor, tasks[first] to tasks[end - 1]; counter is the current tick % divisor and next is the
+// first task whose phase is not below it
+typedef struct {
+    uint16_t divisor;
+    uint16_t counter;
+    uint8_t first;
+    uint8_t end;
+    uint8_t next;
+} Filter_Sched_Group_t;
+
+typedef struct {
+    uint32_t ticks;
+    uint32_t overruns;  // ticks that took longer than the budget
+    uint32_t min_time;
+    uint32_t max_time;
+    uint32_t max_tick;  // tick on which max_time occurred
+    uint64_t total_time;
+} Filter_Sched_Stats_t;
+
+typedef struct {
+    Filter_Sched_Task_t tasks[FILTER_SCHED_MAX_TASKS];
+    Filter_Sched_Group_t groups[FILTER_SCHED_MAX_GROUPS];
+    uint8_t task_count;
+    uint8_t group_count;
+    uint32_t tick;
+    Filter_Sched_Clock_t clock;
+    uint32_t budget;
+    Filter_Sched_Stats_t stats;
+} Filter_Scheduler_t;
+
+/**
+ * Function Filter_Sched_Init clears the task table and statistics.
+ * @param p_sched pointer to the scheduler
+ * @param clock function returning a free running time, NULL to disable timing
+ * @param budget per-tick execution time allowed before a tick counts as an overrun, in clock units
+ */
+void Filter_Sched_Init( Filter_Scheduler_t* p_sched, Filter_Sched_Clock_t clock, uint32_t budget );
+
+/**
+ * Function Filter_Sched_Add_Filter registers a filter that reads *p_input and writes *p_output when it runs.
+ * @param p_sched pointer to the scheduler
+ * @param p_filt pointer to the filter object
+ * @param p_input value filtered on each run
+ * @param p_output where the filtered value is stored, may be NULL
+ * @param divisor run every divisor ticks
+ * @return true if added, false if the task or group table is full or divisor is 0
+ */
+bool Filter_Sched_Add_Filter( Filter_Scheduler_t* p_sched, Filter_Data_t* p_filt, const float* p_input, float* p_output, uint16_t divisor );
+
+/**
+ * Function Filter_Sched_Add_Callback registers a callback.
+ * @param p_sched pointer to the scheduler
+ * @param callback function to run
+ * @param p_context argument passed to callback
+ * @param divisor run every divisor ticks
+ * @return true if added, false if the task or group table is full or divisor is 0
+ */
+bool Filter_Sched_Add_Callback( Filter_Scheduler_t* p_sched, Filter_Sched_Callback_t callback, void* p_context, uint16_t divisor );
+
+/**
+ * Function Filter_Sched_Tick runs every task due on the current tick and advances the tick.
+ * @param p_sched pointer to the scheduler
+ */
+void Filter_Sched_Tick( Filter_Scheduler_t* p_sched );
+
+/**
+ * Function Filter_Sched_Get_Stats copies the per-tick execution time statistics.
+ * @param p_sched pointer to the scheduler
+ * @param p_stats destination for the statistics
+ */
+void Filter_Sched_Get_Stats( const Filter_Scheduler_t* p_sched, Filter_Sched_Stats_t* p_stats );
+
+/**
+ * Function Filter_Sched_Reset_Stats restarts the statistics, e.g. after start-up.
+ * @param p_sched pointer to the scheduler
+ */
+void Filter_Sched_Reset_Stats( Filter_Scheduler_t* p_sched );
+
+#ifndef AVR_MCU
+/**
+ * Function Filter_Sched_Clock_Ns is a CLOCK_MONOTONIC based clock in nanoseconds for use with Filter_Sched_Init.
+ * @return The current time, wrapping every ~4.3 s
+ */
+uint32_t Filter_Sched_Clock_Ns( void );
+#endif
+
+#endif
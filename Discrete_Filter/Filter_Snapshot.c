@@ -0,0 +1,261 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Filter_Snapshot.h"
+
+#include <string.h>  // for memcpy
+
+#ifndef AVR_MCU
+#    include <errno.h>
+#    include <unistd.h>  // for read and write
+#endif
+
+#define SNAPSHOT_HEADER_SIZE 8
+#define BATCH_HEADER_SIZE    5
+
+// Writes the active elements of a ring, returning the advanced write pointer.
+static uint8_t* save_ring( const Ring_Buffer_Float_t* p_buf, uint8_t* p_out, uint8_t length )
+{
+    for( uint8_t i = 0; i < length; i++ ) {
+        float value = rb_get_F( p_buf, i );
+        memcpy( p_out, &value, sizeof( float ) );
+        p_out += sizeof( float );
+    }
+    return p_out;
+}
+
+// Reads length elements back into a ring at their original internal positions.
+static const uint8_t* restore_ring( Ring_Buffer_Float_t* p_buf, uint8_t start_index, const uint8_t* p_in, uint8_t length )
+{
+    p_buf->start_index = start_index;
+    p_buf->end_index   = ( start_index + length ) & ( RB_LENGTH_F - 1 );
+    for( uint8_t i = 0; i < length; i++ ) {
+        float value;
+        memcpy( &value, p_in, sizeof( float ) );
+        rb_set_F( p_buf, i, value );
+        p_in += sizeof( float );
+    }
+    return p_in;
+}
+
+// Checks the SNAPSHOT_HEADER_SIZE header bytes of a snapshot, returning its total size or 0 if it cannot be restored.
+static size_t snapshot_header_check( const uint8_t* p_blob )
+{
+    if( p_blob[0] != 'F' || p_blob[1] != 'S' || p_blob[2] != FILTER_SNAPSHOT_VERSION )
+        return 0;
+
+    // a ring holds at most RB_LENGTH_F - 1 active elements
+    uint8_t coeffs = p_blob[3];
+    if( coeffs == 0 || coeffs >= RB_LENGTH_F )
+        return 0;
+
+    // the start indices are used to index the ring storage directly
+    for( int i = 4; i < SNAPSHOT_HEADER_SIZE; i++ )
+        if( p_blob[i] >= RB_LENGTH_F )
+            return 0;
+
+    return Filter_Save_Size( coeffs - 1 );
+}
+
+// Checks a snapshot, returning its total size or 0 if it cannot be restored or is truncated.
+static size_t snapshot_check( const uint8_t* p_blob, size_t length )
+{
+    if( length < SNAPSHOT_HEADER_SIZE )
+        return 0;
+
+    size_t size = snapshot_header_check( p_blob );
+    return ( size <= length ) ? size : 0;
+}
+
+/**
+ * Function Filter_Save_Size returns the snapshot size for a filter of the given order.
+ * @param order The filter order
+ * @return The snapshot size in bytes
+ */
+size_t Filter_Save_Size( uint8_t order )
+{
+    return SNAPSHOT_HEADER_SIZE + 4 * ( (size_t)order + 1 ) * sizeof( float );
+}
+
+/**
+ * Function Filter_Save serializes the coefficients and history of a filter.
+ * @param p_filt pointer to the filter object
+ * @param p_blob destination buffer
+ * @param capacity size of the destination buffer
+ * @return The number of bytes written, 0 if the buffer is too small
+ */
+size_t Filter_Save( const Filter_Data_t* p_filt, uint8_t* p_blob, size_t capacity )
+{
+    uint8_t coeffs = rb_length_F( &p_filt->numerator );
+    size_t size    = Filter_Save_Size( coeffs - 1 );
+
+    if( coeffs == 0 || size > capacity )
+        return 0;
+
+    p_blob[0] = 'F';
+    p_blob[1] = 'S';
+    p_blob[2] = FILTER_SNAPSHOT_VERSION;
+    p_blob[3] = coeffs;
+    p_blob[4] = p_filt->numerator.start_index;
+    p_blob[5] = p_filt->denominator.start_index;
+    p_blob[6] = p_filt->in_list.start_index;
+    p_blob[7] = p_filt->out_list.start_index;
+
+    uint8_t* p_out = p_blob + SNAPSHOT_HEADER_SIZE;
+    p_out          = save_ring( &p_filt->numerator, p_out, coeffs );
+    p_out          = save_ring( &p_filt->denominator, p_out, coeffs );
+    p_out          = save_ring( &p_filt->in_list, p_out, coeffs );
+    save_ring( &p_filt->out_list, p_out, coeffs );
+
+    return size;
+}
+
+/**
+ * Function Filter_Restore loads a filter from a snapshot. The filter is left untouched if the snapshot is invalid.
+ * @param p_filt pointer to the filter object
+ * @param p_blob snapshot buffer
+ * @param length number of bytes available in the snapshot buffer
+ * @return The number of bytes consumed, 0 if the snapshot is invalid or truncated
+ */
+size_t Filter_Restore( Filter_Data_t* p_filt, const uint8_t* p_blob, size_t length )
+{
+    size_t size = snapshot_check( p_blob, length );
+    if( size == 0 )
+        return 0;
+
+    uint8_t coeffs      = p_blob[3];
+    const uint8_t* p_in = p_blob + SNAPSHOT_HEADER_SIZE;
+    p_in                = restore_ring( &p_filt->numerator, p_blob[4], p_in, coeffs );
+    p_in                = restore_ring( &p_filt->denominator, p_blob[5], p_in, coeffs );
+    p_in                = restore_ring( &p_filt->in_list, p_blob[6], p_in, coeffs );
+    restore_ring( &p_filt->out_list, p_blob[7], p_in, coeffs );
+
+    return size;
+}
+
+#ifndef AVR_MCU
+// Reads exactly length bytes, false on an error or end of file first.
+static bool read_exact( int fd, uint8_t* p_data, size_t length )
+{
+    while( length > 0 ) {
+        ssize_t ret = read( fd, p_data, length );
+        if( ret < 0 && errno == EINTR )
+            continue;
+        if( ret <= 0 )
+            return false;
+        p_data += ret;
+        length -= ret;
+    }
+    return true;
+}
+
+/**
+ * Function Filter_Save_All writes snapshots of an array of filters to a file descriptor with a single write.
+ * @param fd file descriptor to write to
+ * @param p_filts array of filters
+ * @param count number of filters
+ * @param p_scratch buffer used to assemble the snapshots
+ * @param scratch_size size of the scratch buffer
+ * @return true if the snapshots were written completely
+ */
+bool Filter_Save_All( int fd, const Filter_Data_t* p_filts, uint16_t count, uint8_t* p_scratch, size_t scratch_size )
+{
+    if( scratch_size < BATCH_HEADER_SIZE )
+        return false;
+
+    p_scratch[0] = 'F';
+    p_scratch[1] = 'B';
+    p_scratch[2] = FILTER_SNAPSHOT_VERSION;
+    memcpy( p_scratch + 3, &count, sizeof( count ) );
+
+    size_t used = BATCH_HEADER_SIZE;
+    for( uint16_t i = 0; i < count; i++ ) {
+        size_t size = Filter_Save( &p_filts[i], p_scratch + used, scratch_size - used );
+        if( size == 0 )
+            return false;
+        used += size;
+    }
+
+    // a single write normally moves the whole batch; only loop on a short write or a signal
+    size_t written = 0;
+    while( written < used ) {
+        ssize_t ret = write( fd, p_scratch + written, used - written );
+        if( ret < 0 && errno == EINTR )
+            continue;
+        if( ret <= 0 )
+            return false;
+        written += ret;
+    }
+
+    return true;
+}
+
+/**
+ * Function Filter_Restore_All restores an array of filters written by Filter_Save_All.
+ * @param fd file descriptor to read from
+ * @param p_filts array of filters
+ * @param count number of filters, must match the saved count
+ * @param p_scratch buffer the snapshots are read into
+ * @param scratch_size size of the scratch buffer
+ * @return true if all filters were restored
+ */
+bool Filter_Restore_All( int fd, Filter_Data_t* p_filts, uint16_t count, uint8_t* p_scratch, size_t scratch_size )
+{
+    uint16_t saved_count;
+    if( scratch_size < BATCH_HEADER_SIZE || !read_exact( fd, p_scratch, BATCH_HEADER_SIZE ) )
+        return false;
+    if( p_scratch[0] != 'F' || p_scratch[1] != 'B' || p_scratch[2] != FILTER_SNAPSHOT_VERSION )
+        return false;
+    memcpy( &saved_count, p_scratch + 3, sizeof( saved_count ) );
+    if( saved_count != count )
+        return false;
+
+    // read each snapshot header and then exactly the size it declares, so nothing past the batch is consumed, and
+    // validate the whole batch before touching any filter
+    size_t length = BATCH_HEADER_SIZE;
+    for( uint16_t i = 0; i < count; i++ ) {
+        if( scratch_size - length < SNAPSHOT_HEADER_SIZE || !read_exact( fd, p_scratch + length, SNAPSHOT_HEADER_SIZE ) )
+            return false;
+
+        size_t size = snapshot_header_check( p_scratch + length );
+        if( size == 0 || size > scratch_size - length )
+            return false;
+        if( !read_exact( fd, p_scratch + length + SNAPSHOT_HEADER_SIZE, size - SNAPSHOT_HEADER_SIZE ) )
+            return false;
+        length += size;
+    }
+
+    size_t offset = BATCH_HEADER_SIZE;
+    for( uint16_t i = 0; i < count; i++ )
+        offset += Filter_Restore( &p_filts[i], p_scratch + offset, length - offset );
+
+    return true;
+}
+#endif
@@ -0,0 +1,113 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/**
+ * Filter_Snapshot.h/c saves and restores the complete state of a Filter_Data_t so a restarted process can resume with
+ * settled outputs instead of a zero history.
+ *
+ * A snapshot is a compact binary blob:
+ *
+ *  byte 0-1  'F' 'S'  magic
+ *  byte 2    version (FILTER_SNAPSHOT_VERSION)
+ *  byte 3    number of coefficients, order + 1
+ *  byte 4-7  start_index of numerator, denominator, in_list and out_list
+ *  then      numerator, denominator, in_list, out_list active elements as floats
+ *
+ * Only the active elements are stored but they are restored to the same internal positions, so a restored filter is
+ * identical to the saved one. Floats are stored in the machine's native byte order; snapshots are meant for warm
+ * restarts on the same target.
+ *
+ * Filter_Save_All/Filter_Restore_All handle a whole array of filters with a single write/read on a file descriptor,
+ * prefixed by a 'F' 'B' version count header.
+ */
+#ifndef _MEGN540_FILTER_SNAPSHOT_H
+#define _MEGN540_FILTER_SNAPSHOT_H
+
+#include "Filter.h"
+
+#include <stddef.h>  // for size_t
+
+#define FILTER_SNAPSHOT_VERSION 1
+
+/**
+ * Function Filter_Save_Size returns the snapshot size for a filter of the given order.
+ * @param order The filter order
+ * @return The snapshot size in bytes
+ */
+size_t Filter_Save_Size( uint8_t order );
+
+/**
+ * Function Filter_Save serializes the coefficients and history of a filter.
+ * @param p_filt pointer to the filter object
+ * @param p_blob destination buffer
+ * @param capacity size of the destination buffer
+ * @return The number of bytes written, 0 if the buffer is too small
+ */
+size_t Filter_Save( const Filter_Data_t* p_filt, uint8_t* p_blob, size_t capacity );
+
+/**
+ * Function Filter_Restore loads a filter from a snapshot. The filter is left untouched if the snapshot is invalid,
+ * including a coefficient count or start index that does not fit RB_LENGTH_F.
+ * @param p_filt pointer to the filter object
+ * @param p_blob snapshot buffer
+ * @param length number of bytes available in the snapshot buffer
+ * @return The number of bytes consumed, 0 if the snapshot is invalid or truncated
+ */
+size_t Filter_Restore( Filter_Data_t* p_filt, const uint8_t* p_blob, size_t length );
+
+#ifndef AVR_MCU
+#    include <stdbool.h>
+
+/**
+ * Function Filter_Save_All writes snapshots of an array of filters to a file descriptor with a single write.
+ * @param fd file descriptor to write to
+ * @param p_filts array of filters
+ * @param count number of filters
+ * @param p_scratch buffer used to assemble the snapshots
+ * @param scratch_size size of the scratch buffer, at least 5 + the sum of Filter_Save_Size for each filter
+ * @return true if the snapshots were written completely
+ */
+bool Filter_Save_All( int fd, const Filter_Data_t* p_filts, uint16_t count, uint8_t* p_scratch, size_t scratch_size );
+
+/**
+ * Function Filter_Restore_All restores an array of filters written by Filter_Save_All. Filters are only modified if
+ * every snapshot in the batch is valid. Exactly the bytes of the batch are read, so it can be followed by other data
+ * on a pipe or socket.
+ * @param fd file descriptor to read from
+ * @param p_filts array of filters
+ * @param count number of filters, must match the saved count
+ * @param p_scratch buffer the snapshots are read into
+ * @param scratch_size size of the scratch buffer
+ * @return true if all filters were restored
+ */
+bool Filter_Restore_All( int fd, Filter_Data_t* p_filts, uint16_t count, uint8_t* p_scratch, size_t scratch_size );
+#endif
+
+#endif
@@ -0,0 +1,173 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Filter.h"
+#include "Filter_Pipeline_Threaded.h"
+#include "Filter_Samples.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Synthetic load: a sine wave delivered as raw float bytes in chunks of up to 4 KiB, like bursts off a socket.
+typedef struct {
+    uint64_t remaining;
+    uint64_t index;
+} Synthetic_Source_t;
+
+static size_t synthetic_source( void* p_context, uint8_t* p_bytes, size_t capacity )
+{
+    Synthetic_Source_t* p_src = (Synthetic_Source_t*)p_context;
+    size_t count              = capacity / sizeof( float );
+    if( count > 1024 )
+        count = 1024;
+    if( count > p_src->remaining )
+        count = p_src->remaining;
+
+    for( size_t i = 0; i < count; i++ ) {
+        float value = sinf( ( p_src->index + i ) * 0.01f );
+        memcpy( p_bytes + i * sizeof( float ), &value, sizeof( float ) );
+    }
+
+    p_src->index += count;
+    p_src->remaining -= count;
+    return count * sizeof( float );
+}
+
+static void checksum_sink( void* p_context, const float* p_samples, size_t count )
+{
+    double* p_sum = (double*)p_context;
+    for( size_t i = 0; i < count; i++ )
+        *p_sum += p_samples[i];
+}
+
+static double now_s( void )
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+#define OFFLINE_FRAMES 2000000
+#define OFFLINE_CSV    "/tmp/disc_filter_bench.csv"
+#define OFFLINE_BIN    "/tmp/disc_filter_bench.fsmp"
+
+// offline filtering of one channel: parse CSV and Filter_Value per value, vs. mapped sample file and Filter_Value_Block
+static void offline_run( float* num, float* den )
+{
+    FILE* p_csv = fopen( OFFLINE_CSV, "w" );
+    if( p_csv == NULL )
+        return;
+    for( uint32_t i = 0; i < OFFLINE_FRAMES; i++ )
+        fprintf( p_csv, "%.6f\n", sinf( i * 0.001f ) );
+    fclose( p_csv );
+
+    Filter_Data_t filt;
+    double sum_text = 0, sum_binary = 0;
+
+    Filter_Init( &filt, num, den, 4 );
+    double start = now_s();
+    char line[64];
+    p_csv = fopen( OFFLINE_CSV, "r" );
+    while( fgets( line, sizeof( line ), p_csv ) != NULL )
+        sum_text += Filter_Value( &filt, strtof( line, NULL ) );
+    fclose( p_csv );
+    double text_s = now_s() - start;
+
+    start        = now_s();
+    long frames  = Filter_Samples_From_CSV( OFFLINE_CSV, OFFLINE_BIN, 1000.0f );
+    double csv_s = now_s() - start;
+
+    Filter_Samples_Reader_t reader;
+    float* p_out = malloc( OFFLINE_FRAMES * sizeof( float ) );
+    if( frames == OFFLINE_FRAMES && p_out != NULL && Filter_Samples_Open( &reader, OFFLINE_BIN ) ) {
+        Filter_Init( &filt, num, den, 4 );
+        start = now_s();
+        Filter_Samples_Filter( &reader, 0, &filt, p_out );
+        for( uint32_t i = 0; i < OFFLINE_FRAMES; i++ )
+            sum_binary += p_out[i];
+        double binary_s = now_s() - start;
+        Filter_Samples_Release( &reader );
+
+        printf( "\nOffline filtering, %i samples, Msamples/s\n", OFFLINE_FRAMES );
+        printf( "CSV + Filter_Value:          %8.2f\n", OFFLINE_FRAMES / text_s * 1e-6 );
+        printf( "sample file + block filter:  %8.2f  (one-off CSV conversion %.2f s, outputs %s)\n", OFFLINE_FRAMES / binary_s * 1e-6, csv_s,
+                ( sum_text == sum_binary ) ? "identical" : "DIFFER" );
+    }
+
+    free( p_out );
+    remove( OFFLINE_CSV );
+    remove( OFFLINE_BIN );
+}
+
+int main()
+{
+    float num[] = { 0.046582906636443696668514746761502, 0.18633162654577478667405898704601, 0.2794974398186621522555128649401,
+                    0.18633162654577478667405898704601, 0.046582906636443696668514746761502 };
+    float den[] = { 1.0, -0.78209519802333749005640584073262, 0.67997852691629945276474700222025, -0.18267569775303207912919845057331,
+                    0.030118875043169249239305429455271 };
+
+    static Filter_Threaded_Pipeline_t pipe;
+    uint32_t batches[] = { 16, 64, 256 };
+
+    // the same stream filtered sequentially, to check the pipeline output
+    Filter_Data_t reference;
+    Filter_Init( &reference, num, den, 4 );
+    double reference_sum = 0;
+    for( uint32_t i = 0; i < 10000000; i++ )
+        reference_sum += Filter_Value( &reference, sinf( i * 0.01f ) );
+
+    printf( "Threaded pipeline, 4th order filter, %i samples per run\n", 10000000 );
+    for( int b = 0; b < 3; b++ ) {
+        Filter_Data_t filt;
+        Filter_Init( &filt, num, den, 4 );
+
+        Synthetic_Source_t source = { 10000000, 0 };
+        double sum                = 0;
+        Filter_Threaded_Stats_t stats;
+
+        Filter_Threaded_Init( &pipe, synthetic_source, &source, &filt, checksum_sink, &sum, batches[b] );
+        if( !Filter_Threaded_Run( &pipe, &stats ) ) {
+            printf( "Failed to start pipeline threads.\n" );
+            return 1;
+        }
+
+        printf( "batch %4u: %6.2f Msamples/s, latency min/mean/max %8.1f/%8.1f/%8.1f us over %llu samples, stalls %llu/%llu, output %s\n",
+                batches[b], stats.samples_per_second * 1e-6, stats.latency_min_ns * 1e-3, stats.latency_mean_ns * 1e-3, stats.latency_max_ns * 1e-3,
+                (unsigned long long)stats.latency_count, (unsigned long long)stats.decode_stalls, (unsigned long long)stats.filter_stalls,
+                ( sum == reference_sum ) ? "matches Filter_Value" : "DIFFERS" );
+    }
+
+    offline_run( num, den );
+
+    return 0;
+}
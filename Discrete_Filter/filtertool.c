@@ -0,0 +1,336 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/*
+ * filtertool streams recorded samples through a filter, for offline use in place of scripts that call Filter_Value
+ * sample by sample.
+ *
+ *   filtertool -n b0,b1,... -d a0,a1,... [-j threads] [-B] [-o output] [input]
+ *
+ *   -n  numerator coefficients, comma separated
+ *   -d  denominator coefficients, the same number as the numerator
+ *   -j  worker threads for multi-channel input, 0 for one per CPU (default 1); the workers are started once and
+ *       filter every block through Filter_Bank_Pool_Run
+ *   -B  input and output are sample files (Filter_Samples.h) instead of text; -o is then required
+ *   -o  output file, default stdout
+ *   input file, default stdin
+ *
+ * Text input has one frame per line, channels separated by commas or whitespace; lines that do not start with a number
+ * are skipped and the first numeric line sets the channel count, at most FILTERTOOL_CHANNELS. A sample file must
+ * hold whole frames, and as many as its header says unless the frame count was left at 0 by a writer that never
+ * closed it. Every channel has its own filter with the same coefficients. Input is read and filtered
+ * FILTERTOOL_BLOCK frames at a time, so memory use does not depend on the file size. Throughput and the most workers
+ * any block ran on are printed to stderr at the end.
+ */
+
+#include "Filter.h"
+#include "Filter_Bank.h"
+#include "Filter_Samples.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FILTERTOOL_BLOCK    65536  // frames filtered per block
+#define FILTERTOOL_CHANNELS 256
+#define FILTERTOOL_IO_BYTES ( 1 << 20 )
+#define FILTERTOOL_LINE     8192
+
+typedef struct {
+    Filter_Data_t filters[FILTERTOOL_CHANNELS];
+    Filter_Channel_t channels[FILTERTOOL_CHANNELS];
+    float* p_blocks;  // channel_count blocks of FILTERTOOL_BLOCK samples
+    uint16_t channel_count;
+    uint16_t threads;
+    bool pooled;       // pool is started
+    uint16_t workers;  // most workers any block ran on
+    Filter_Bank_Pool_t pool;
+} Filtertool_t;
+
+static void usage( void )
+{
+    fprintf( stderr, "usage: filtertool -n b0,b1,... -d a0,a1,... [-j threads] [-B] [-o output] [input]\n" );
+    exit( 2 );
+}
+
+static double now_s( void )
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// parses up to capacity values separated by commas or whitespace, returns how many or capacity + 1 if more follow
+static size_t parse_values( const char* p_text, float* p_values, size_t capacity )
+{
+    size_t count = 0;
+    char* p_end;
+
+    for( ;; ) {
+        float value = strtof( p_text, &p_end );
+        if( p_end == p_text )
+            break;
+        if( count == capacity )
+            return capacity + 1;
+
+        p_values[count++] = value;
+        p_text            = p_end + strspn( p_end, ", \t\r\n" );
+    }
+    return count;
+}
+
+static bool tool_setup( Filtertool_t* p_tool, uint16_t channel_count, float* num, float* den, uint8_t order )
+{
+    if( channel_count == 0 || channel_count > FILTERTOOL_CHANNELS )
+        return false;
+
+    p_tool->channel_count = channel_count;
+    p_tool->p_blocks      = malloc( (size_t)channel_count * FILTERTOOL_BLOCK * sizeof( float ) );
+    for( uint16_t c = 0; c < channel_count; c++ )
+        Filter_Init( &p_tool->filters[c], num, den, order );
+
+    p_tool->workers = 1;
+    p_tool->pooled  = p_tool->threads != 1 && channel_count > 1;
+    if( p_tool->pooled )
+        Filter_Bank_Pool_Start( &p_tool->pool, p_tool->threads );
+    return p_tool->p_blocks != NULL;
+}
+
+// filters frame_count frames of every channel block in place
+static void tool_filter( Filtertool_t* p_tool, size_t frame_count )
+{
+    for( uint16_t c = 0; c < p_tool->channel_count; c++ ) {
+        float* p_block      = p_tool->p_blocks + (size_t)c * FILTERTOOL_BLOCK;
+        p_tool->channels[c] = (Filter_Channel_t){ &p_tool->filters[c], 1, p_block, p_block, frame_count };
+    }
+
+    // one channel per chunk: sizing chunks by cache would put every channel of a typical file on a single worker, and
+    // a whole block of one channel is plenty of work to hand out
+    if( p_tool->pooled ) {
+        Filter_Bank_Stats_t stats;
+        Filter_Bank_Pool_Run( &p_tool->pool, p_tool->channels, p_tool->channel_count, 1, &stats );
+        if( stats.threads > p_tool->workers )
+            p_tool->workers = stats.threads;
+    }
+    else
+        for( uint16_t c = 0; c < p_tool->channel_count; c++ )
+            Filter_Value_Block( &p_tool->filters[c], p_tool->channels[c].p_input, p_tool->channels[c].p_output, frame_count );
+}
+
+static void write_text( const Filtertool_t* p_tool, FILE* p_out, size_t frame_count )
+{
+    for( size_t f = 0; f < frame_count; f++ )
+        for( uint16_t c = 0; c < p_tool->channel_count; c++ )
+            fprintf( p_out, ( c + 1 < p_tool->channel_count ) ? "%.9g," : "%.9g\n", p_tool->p_blocks[(size_t)c * FILTERTOOL_BLOCK + f] );
+}
+
+static uint64_t run_text( Filtertool_t* p_tool, FILE* p_in, FILE* p_out, float* num, float* den, uint8_t order )
+{
+    static char line[FILTERTOOL_LINE];
+    float values[FILTERTOOL_CHANNELS];
+    uint64_t frames = 0;
+    size_t filled   = 0;
+
+    while( fgets( line, sizeof( line ), p_in ) != NULL ) {
+        // a line that filled the buffer without its newline was split, unless the newline or the end of the file is next
+        size_t length = strlen( line );
+        if( length == sizeof( line ) - 1 && line[length - 1] != '\n' ) {
+            int next = fgetc( p_in );
+            if( next != EOF && next != '\n' ) {
+                fprintf( stderr, "filtertool: line after frame %llu is longer than %d characters\n", (unsigned long long)frames, FILTERTOOL_LINE - 1 );
+                exit( 1 );
+            }
+        }
+
+        size_t count = parse_values( line, values, FILTERTOOL_CHANNELS );
+        if( count == 0 )
+            continue;
+        if( count > FILTERTOOL_CHANNELS ) {
+            fprintf( stderr, "filtertool: frame %llu has more than %u values\n", (unsigned long long)frames + 1, FILTERTOOL_CHANNELS );
+            exit( 1 );
+        }
+
+        if( p_tool->p_blocks == NULL && !tool_setup( p_tool, (uint16_t)count, num, den, order ) ) {
+            fprintf( stderr, "filtertool: cannot handle %zu channels\n", count );
+            exit( 1 );
+        }
+        if( count != p_tool->channel_count ) {
+            fprintf( stderr, "filtertool: frame %llu has %zu values, expected %u\n", (unsigned long long)frames + 1, count, p_tool->channel_count );
+            exit( 1 );
+        }
+
+        for( uint16_t c = 0; c < count; c++ )
+            p_tool->p_blocks[(size_t)c * FILTERTOOL_BLOCK + filled] = values[c];
+        frames++;
+
+        if( ++filled == FILTERTOOL_BLOCK ) {
+            tool_filter( p_tool, filled );
+            write_text( p_tool, p_out, filled );
+            filled = 0;
+        }
+    }
+
+    if( filled > 0 ) {
+        tool_filter( p_tool, filled );
+        write_text( p_tool, p_out, filled );
+    }
+    return frames;
+}
+
+static uint64_t run_binary( Filtertool_t* p_tool, FILE* p_in, const char* out_path, float* num, float* den, uint8_t order )
+{
+    Filter_Samples_Header_t header;
+    Filter_Samples_Writer_t writer;
+    uint64_t frames = 0;
+
+    if( fread( &header, sizeof( header ), 1, p_in ) != 1 || memcmp( header.magic, "FSMP", 4 ) != 0 || header.version != FILTER_SAMPLES_VERSION
+        || header.sample_type != FILTER_SAMPLES_FLOAT32 ) {
+        fprintf( stderr, "filtertool: input is not a sample file\n" );
+        exit( 1 );
+    }
+    if( !tool_setup( p_tool, header.channel_count, num, den, order ) || !Filter_Samples_Create( &writer, out_path, header.channel_count, header.sample_rate ) ) {
+        fprintf( stderr, "filtertool: cannot set up %u channels into %s\n", header.channel_count, out_path );
+        exit( 1 );
+    }
+
+    // frames are interleaved in the file and planar in the blocks
+    size_t channels    = p_tool->channel_count;
+    size_t frame_bytes = channels * sizeof( float );
+    float* p_frames    = malloc( frame_bytes * FILTERTOOL_BLOCK );
+    size_t bytes;
+    if( p_frames == NULL ) {
+        fprintf( stderr, "filtertool: cannot allocate a block of %u frames\n", FILTERTOOL_BLOCK );
+        exit( 1 );
+    }
+    while( ( bytes = fread( p_frames, 1, frame_bytes * FILTERTOOL_BLOCK, p_in ) ) > 0 ) {
+        if( bytes % frame_bytes != 0 ) {
+            fprintf( stderr, "filtertool: input ends in a partial frame after %llu frames\n", (unsigned long long)( frames + bytes / frame_bytes ) );
+            exit( 1 );
+        }
+
+        size_t frame_count = bytes / frame_bytes;
+        for( size_t f = 0; f < frame_count; f++ )
+            for( size_t c = 0; c < channels; c++ )
+                p_tool->p_blocks[c * FILTERTOOL_BLOCK + f] = p_frames[f * channels + c];
+
+        tool_filter( p_tool, frame_count );
+
+        for( size_t f = 0; f < frame_count; f++ )
+            for( size_t c = 0; c < channels; c++ )
+                p_frames[f * channels + c] = p_tool->p_blocks[c * FILTERTOOL_BLOCK + f];
+
+        if( !Filter_Samples_Write( &writer, p_frames, frame_count * channels ) ) {
+            fprintf( stderr, "filtertool: write to %s failed\n", out_path );
+            exit( 1 );
+        }
+        frames += frame_count;
+    }
+
+    free( p_frames );
+    if( ferror( p_in ) ) {
+        perror( "filtertool: input" );
+        exit( 1 );
+    }
+    if( header.frame_count != 0 && header.frame_count != frames ) {
+        fprintf( stderr, "filtertool: input header says %llu frames but holds %llu\n", (unsigned long long)header.frame_count, (unsigned long long)frames );
+        exit( 1 );
+    }
+    if( !Filter_Samples_Close( &writer ) ) {
+        fprintf( stderr, "filtertool: could not complete %s\n", out_path );
+        exit( 1 );
+    }
+    return frames;
+}
+
+int main( int argc, char** argv )
+{
+    static Filtertool_t tool;
+    float num[RB_LENGTH_F], den[RB_LENGTH_F];
+    size_t num_count = 0, den_count = 0;
+    const char* out_path = NULL;
+    bool binary          = false;
+    int option;
+
+    tool.threads = 1;
+    while( ( option = getopt( argc, argv, "n:d:j:Bo:" ) ) != -1 ) {
+        switch( option ) {
+            case 'n': num_count = parse_values( optarg, num, RB_LENGTH_F ); break;
+            case 'd': den_count = parse_values( optarg, den, RB_LENGTH_F ); break;
+            case 'j': tool.threads = (uint16_t)atoi( optarg ); break;
+            case 'B': binary = true; break;
+            case 'o': out_path = optarg; break;
+            default: usage();
+        }
+    }
+
+    // the filter's ring buffers hold at most RB_LENGTH_F - 1 coefficients
+    if( num_count == 0 || num_count != den_count || num_count >= RB_LENGTH_F || den[0] == 0.0f || optind + 1 < argc || ( binary && out_path == NULL ) )
+        usage();
+    uint8_t order = (uint8_t)( num_count - 1 );
+
+    FILE* p_in = ( optind < argc && strcmp( argv[optind], "-" ) != 0 ) ? fopen( argv[optind], binary ? "rb" : "r" ) : stdin;
+    if( p_in == NULL ) {
+        perror( argv[optind] );
+        return 1;
+    }
+    setvbuf( p_in, NULL, _IOFBF, FILTERTOOL_IO_BYTES );
+
+    double start    = now_s();
+    uint64_t frames = 0;
+    if( binary ) {
+        frames = run_binary( &tool, p_in, out_path, num, den, order );
+    } else {
+        FILE* p_out = ( out_path != NULL ) ? fopen( out_path, "w" ) : stdout;
+        if( p_out == NULL ) {
+            perror( out_path );
+            return 1;
+        }
+        setvbuf( p_out, NULL, _IOFBF, FILTERTOOL_IO_BYTES );
+        frames = run_text( &tool, p_in, p_out, num, den, order );
+        if( fclose( p_out ) != 0 ) {
+            perror( "filtertool: output" );
+            return 1;
+        }
+    }
+    double elapsed = now_s() - start;
+
+    fclose( p_in );
+    free( tool.p_blocks );
+    if( tool.pooled )
+        Filter_Bank_Pool_Stop( &tool.pool );
+
+    uint64_t samples = frames * tool.channel_count;
+    fprintf( stderr, "filtertool: %llu frames x %u channels on %u workers in %.3f s, %.2f Msamples/s\n", (unsigned long long)frames, tool.channel_count,
+             tool.workers, elapsed,
+             elapsed > 0 ? samples / elapsed * 1e-6 : 0.0 );
+    return 0;
+}
@@ -0,0 +1,93 @@
+#!/bin/sh
+# Filters one 3 channel signal as text and as a sample file, on 1 and 4 threads, and checks that every output agrees.
+# The signal is longer than FILTERTOOL_BLOCK frames so filter state has to carry from block to block. Also checks
+# that the 4 thread runs really used more than one worker, and that a sample file ending in a partial frame, one
+# shorter than its header says, a text line with more than FILTERTOOL_CHANNELS values and a text line longer than
+# FILTERTOOL_LINE are refused.
+#
+#   filtertool_check.sh path/to/filtertool
+set -e
+tool=$1
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+export LC_ALL=C
+
+frames=70000
+awk -v frames=$frames -v text="$dir/in.txt" -v bin="$dir/in.fsmp" '
+BEGIN {
+    split( "0 0.5 1 2 -1 -0.25", value, " " )
+    split( "0,0,0,0 0,0,0,63 0,0,128,63 0,0,0,64 0,0,128,191 0,0,128,190", bytes, " " )  # little-endian float32
+
+    # header: magic, version 1, float32, 3 channels, 100 Hz, reserved, frame count, reserved
+    printf "FSMP%c%c%c%c%c%c%c%c", 1, 1, 3, 0, 0, 0, 200, 66 > bin
+    printf "%c%c%c%c", 0, 0, 0, 0 > bin
+    count = frames
+    for( i = 0; i < 8; i++ ) {
+        printf "%c", count % 256 > bin
+        count = int( count / 256 )
+    }
+    for( i = 0; i < 8; i++ )
+        printf "%c", 0 > bin
+
+    for( f = 0; f < frames; f++ ) {
+        line = ""
+        for( c = 0; c < 3; c++ ) {
+            k    = ( f * 7 + c * 5 + int( f / 13 ) ) % 6 + 1
+            line = line ( c ? "," : "" ) value[k]
+            split( bytes[k], b, "," )
+            printf "%c%c%c%c", b[1], b[2], b[3], b[4] > bin
+        }
+        print line > text
+    }
+}'
+
+for threads in 1 4; do
+    "$tool" -n 0.2,0.3,0.1 -d 1,-0.5,0.2 -j $threads -o "$dir/out$threads.txt" "$dir/in.txt" 2>"$dir/log$threads.txt"
+    "$tool" -n 0.2,0.3,0.1 -d 1,-0.5,0.2 -j $threads -B -o "$dir/out$threads.fsmp" "$dir/in.fsmp" 2>>"$dir/log$threads.txt"
+done
+# both summary lines read "... on <n> workers ..." and 3 channels should spread over more than one
+awk '{ for( i = 2; i < NF; i++ ) if( $(i + 1) == "workers" && $(i - 1) == "on" && $i > 1 ) spread++ }
+     END { if( spread != 2 ) { print "filtertool_check: -j 4 ran on a single worker"; exit 1 } }' "$dir/log4.txt"
+cmp "$dir/out1.txt" "$dir/out4.txt"
+cmp "$dir/out1.fsmp" "$dir/out4.fsmp"
+
+# the text output is printed with %.9g, which reads back as the same float
+od -An -v -f -w12 -j32 "$dir/out1.fsmp" | awk -v frames=$frames -v text="$dir/out1.txt" '
+{
+    getline line < text
+    split( line, expected, "," )
+    for( c = 1; c <= 3; c++ ) {
+        difference = $c - expected[c]
+        if( difference * difference > 1e-14 * ( $c * $c + 1e-30 ) ) {
+            printf "filtertool_check: frame %d channel %d is %s as text and %s as a sample file\n", NR, c, expected[c], $c
+            exit 1
+        }
+    }
+}
+END {
+    if( NR != frames ) {
+        printf "filtertool_check: sample file output has %d frames, expected %d\n", NR, frames
+        exit 1
+    }
+}'
+
+head -c -2 "$dir/in.fsmp" > "$dir/partial.fsmp"
+head -c -12 "$dir/in.fsmp" > "$dir/short.fsmp"
+awk 'BEGIN { for( i = 0; i < 257; i++ ) printf "%d%s", i, ( i < 256 ) ? "," : "\n" }' > "$dir/wide.txt"
+# 8186 spaces and "1,2,3" fill the 8192 byte line buffer, so a split line would read as the frames 1,2,3 and 4,5,6
+awk 'BEGIN { printf "0,0,0\n"; for( i = 0; i < 8186; i++ ) printf " "; printf "1,2,34,5,6\n" }' > "$dir/long.txt"
+for bad in partial.fsmp short.fsmp; do
+    if "$tool" -n 1 -d 1 -B -o "$dir/bad.fsmp" "$dir/$bad" 2>/dev/null; then
+        echo "filtertool_check: $bad was accepted"
+        exit 1
+    fi
+done
+if "$tool" -n 1 -d 1 -o "$dir/bad.txt" "$dir/wide.txt" 2>/dev/null; then
+    echo "filtertool_check: a line of 257 values was accepted"
+    exit 1
+fi
+if "$tool" -n 1 -d 1 -o "$dir/bad.txt" "$dir/long.txt" 2>/dev/null; then
+    echo "filtertool_check: a line longer than the line buffer was accepted"
+    exit 1
+fi
+echo "filtertool_check: passed"
@@ -29,9 +29,94 @@
 */
  
 #include "Filter.h"
+#include "Filter_Bank.h"
+#include "Filter_Compact.h"
+#include "Filter_Hotswap.h"
+#include "Filter_Pipeline.h"
+#include "Filter_Pipeline_Threaded.h"
+#include "Filter_Samples.h"
+#include "Filter_Scheduler.h"
+#include "Filter_Snapshot.h"
 
 #include <math.h>  // max
+#include <pthread.h>
 #include <stdio.h>
+#include <string.h>  // for memcmp
+#include <unistd.h>  // for pipe
+
+// Hot-swap writer: publishes sets whose numerator coefficients all equal the publish count, so a filter that ever
+// sees mixed numerator values has read a torn set.
+static atomic_bool hotswap_done;
+static void* hotswap_writer( void* p_arg )
+{
+    Filter_Coeff_Slot_t* p_slot = (Filter_Coeff_Slot_t*)p_arg;
+    float num[]                 = { 0, 0, 0, 0, 0 };
+    float den[]                 = { 1, 0, 0, 0, 0 };
+    int published               = 0;
+
+    while( !atomic_load( &hotswap_done ) ) {
+        for( int i = 0; i < 5; i++ )
+            num[i] = published + 1;
+        if( Filter_Slot_Publish( p_slot, num, den, 4 ) )
+            published++;
+    }
+
+    return NULL;
+}
+
+// Deterministic test signal for the filter bank check, in [-1, 1]
+static float bank_signal( int channel, int i )
+{
+    return ( ( i * 37 + channel * 11 ) % 101 ) * 0.02f - 1;
+}
+
+// Threaded pipeline source: bank_signal( 0, i ) as raw float bytes in 7 byte reads, so floats are split across reads
+typedef struct {
+    uint32_t byte;
+    uint32_t total;
+} Threaded_Source_t;
+
+static size_t threaded_source( void* p_context, uint8_t* p_bytes, size_t capacity )
+{
+    Threaded_Source_t* p_src = (Threaded_Source_t*)p_context;
+    size_t count             = 0;
+    for( ; count < capacity && count < 7 && p_src->byte < p_src->total; count++, p_src->byte++ ) {
+        float value    = bank_signal( 0, p_src->byte / sizeof( float ) );
+        p_bytes[count] = ( (const uint8_t*)&value )[p_src->byte % sizeof( float )];
+    }
+    return count;
+}
+
+// Threaded pipeline sink: appends to an array
+typedef struct {
+    float* p_samples;
+    size_t count;
+} Threaded_Sink_t;
+
+static void threaded_sink( void* p_context, const float* p_samples, size_t count )
+{
+    Threaded_Sink_t* p_sink = (Threaded_Sink_t*)p_context;
+    memcpy( p_sink->p_samples + p_sink->count, p_samples, count * sizeof( float ) );
+    p_sink->count += count;
+}
+
+// Scheduler callback: counts runs and how many did not land on the same tick % divisor as the first
+typedef struct {
+    const Filter_Scheduler_t* p_sched;
+    uint16_t divisor;
+    uint32_t runs;
+    uint32_t first_tick;
+    uint32_t wrong_tick;
+} Sched_Check_t;
+
+static void sched_check_run( void* p_context )
+{
+    Sched_Check_t* p_check = (Sched_Check_t*)p_context;
+    if( p_check->runs == 0 )
+        p_check->first_tick = p_check->p_sched->tick;
+    p_check->wrong_tick += ( p_check->p_sched->tick % p_check->divisor ) != ( p_check->first_tick % p_check->divisor );
+    p_check->runs++;
+}
 
 int main()
 {
@@ -256,6 +341,435 @@ int main()
         printf( "Error %f, correct %f", Filter_Last_Output( &moving_average ), filt_last );
     }
 
+    // Retune: doubling the gain of a settled moving average over 100 samples must not step the output
+    float num_double[] = { 2, 2, 2, 2, 2 };
+    Filter_Ramp_t ramp;
+    Filter_Init( &moving_average, num, den, 4 );
+    Filter_Ramp_Init( &ramp );
+    float ramp_last = 0;
+    for( int i = 0; i < 10; i++ )
+        ramp_last = Filter_Ramp_Value( &moving_average, &ramp, 1 );
+
+    Filter_Retune( &moving_average, &ramp, num_double, den, 4, 100 );
+    float max_step = 0;
+    for( int i = 0; i < 150; i++ ) {
+        float ramp_out = Filter_Ramp_Value( &moving_average, &ramp, 1 );
+        if( fabs( ramp_out - ramp_last ) > max_step )
+            max_step = fabs( ramp_out - ramp_last );
+        ramp_last = ramp_out;
+    }
+
+    total_score++;
+    if( max_step < 0.02 && fabs( ramp_last - 2 ) < 1e-5 ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Retune: largest output step %f, final output %f, should be under 0.02 and 2.\n", max_step, ramp_last );
+    }
+
+    // Snapshots: a batch round trip through a pipe must resume identically and leave the bytes after it unread, and a
+    // snapshot with an out of range start index must be refused
+    Filter_Data_t saved[2], restored[2];
+    uint8_t scratch[512];
+    int snap_fds[2];
+    char trailer[3] = { 0 };
+    Filter_Init( &saved[0], num, den, 4 );
+    Filter_Init( &saved[1], num2, den2, 4 );
+    for( int i = 0; i < 3 * RB_LENGTH_F; i++ ) {
+        Filter_Value( &saved[0], i );
+        Filter_Value( &saved[1], i );
+    }
+    Filter_Init( &restored[0], num2, den2, 2 );
+    Filter_Init( &restored[1], num2, den2, 2 );
+
+    bool snap_ok = pipe( snap_fds ) == 0 && Filter_Save_All( snap_fds[1], saved, 2, scratch, sizeof( scratch ) )
+                   && write( snap_fds[1], "XY", 2 ) == 2 && Filter_Restore_All( snap_fds[0], restored, 2, scratch, sizeof( scratch ) )
+                   && read( snap_fds[0], trailer, 2 ) == 2 && strcmp( trailer, "XY" ) == 0;
+    for( int i = 0; snap_ok && i < 20; i++ )
+        for( int j = 0; j < 2; j++ )
+            snap_ok = Filter_Value( &saved[j], -i ) == Filter_Value( &restored[j], -i );
+    close( snap_fds[0] );
+    close( snap_fds[1] );
+
+    size_t snap_size     = Filter_Save( &saved[0], scratch, sizeof( scratch ) );
+    scratch[4]           = RB_LENGTH_F;
+    Filter_Data_t before = restored[0];
+    snap_ok &= snap_size > 0 && Filter_Restore( &restored[0], scratch, snap_size ) == 0 && memcmp( &before, &restored[0], sizeof( before ) ) == 0;
+
+    total_score++;
+    if( snap_ok ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Save_All/Filter_Restore_All: round trip differs, over-reads, or a corrupt snapshot was accepted.\n" );
+    }
+
+    // Ring pipeline: raw float bytes fed in uneven pieces into a byte ring that starts off a float boundary, so every
+    // fourth float is split across its wrap point, must come out of the output ring bit for bit equal to Filter_Value
+    enum { PIPE_LENGTH = 600 };
+    Ring_Buffer_Byte_t pipe_bytes;
+    Ring_Buffer_Float_t pipe_samples, pipe_output;
+    Filter_Data_t pipe_filt, pipe_ref;
+    Filter_Pipeline_t pipe;
+    uint32_t pipe_fed = 0, pipe_checked = 0;
+    int pipe_mismatch = 0;
+
+    rb_initialize_B( &pipe_bytes );
+    rb_initialize_F( &pipe_samples );
+    rb_initialize_F( &pipe_output );
+    pipe_bytes.start_index = pipe_bytes.end_index = 3;
+    Filter_Init( &pipe_filt, num2, den2, 4 );
+    Filter_Init( &pipe_ref, num2, den2, 4 );
+    Filter_Pipeline_Init( &pipe, &pipe_bytes, &pipe_samples, &pipe_filt, &pipe_output );
+
+    for( int round = 0; round < 100000 && pipe_checked < PIPE_LENGTH; round++ ) {
+        for( int piece = 1 + round % 7; piece > 0 && pipe_fed < PIPE_LENGTH * sizeof( float ) && rb_length_B( &pipe_bytes ) < RB_LENGTH_B - 1;
+             piece--, pipe_fed++ ) {
+            float value = bank_signal( 3, pipe_fed / sizeof( float ) );
+            rb_push_back_B( &pipe_bytes, ( (const uint8_t*)&value )[pipe_fed % sizeof( float )] );
+        }
+
+        // the stages one at a time as well as together
+        if( round % 3 == 0 ) {
+            Filter_Pipeline_Run( &pipe );
+        } else {
+            Filter_Pipeline_Decode( &pipe );
+            Filter_Pipeline_Filter( &pipe );
+        }
+
+        while( rb_length_F( &pipe_output ) > 0 ) {
+            float expected = Filter_Value( &pipe_ref, bank_signal( 3, pipe_checked++ ) );
+            float got      = rb_pop_front_F( &pipe_output );
+            pipe_mismatch += memcmp( &got, &expected, sizeof( float ) ) != 0;
+        }
+    }
+
+    total_score++;
+    if( pipe_checked == PIPE_LENGTH && pipe.decoded == PIPE_LENGTH && pipe.filtered == PIPE_LENGTH && pipe_mismatch == 0 ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Pipeline_Run: %u of %u samples arrived, %i differ from Filter_Value.\n", pipe_checked, PIPE_LENGTH, pipe_mismatch );
+    }
+
+    // Threaded pipeline: the filtered stream must match Filter_Value sample by sample
+    enum { THREADED_LENGTH = 5000 };
+    static Filter_Threaded_Pipeline_t threaded;
+    static float threaded_out[THREADED_LENGTH];
+    Threaded_Source_t threaded_src = { 0, THREADED_LENGTH * sizeof( float ) };
+    Threaded_Sink_t threaded_dst   = { threaded_out, 0 };
+    Filter_Data_t threaded_filt[2];
+    Filter_Init( &threaded_filt[0], num2, den2, 4 );
+    Filter_Init( &threaded_filt[1], num2, den2, 4 );
+    Filter_Threaded_Init( &threaded, threaded_source, &threaded_src, &threaded_filt[0], threaded_sink, &threaded_dst, 16 );
+    bool threaded_ok = Filter_Threaded_Run( &threaded, NULL ) && threaded_dst.count == THREADED_LENGTH;
+    for( int i = 0; threaded_ok && i < THREADED_LENGTH; i++ )
+        threaded_ok = Filter_Value( &threaded_filt[1], bank_signal( 0, i ) ) == threaded_out[i];
+
+    total_score++;
+    if( threaded_ok ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Threaded_Run: %zu samples delivered, output differs from Filter_Value or the run failed.\n", threaded_dst.count );
+    }
+
+    // Scheduler: over 1000 ticks every task runs exactly 1000 / divisor times on a fixed tick % divisor, and the four
+    // 10-tick tasks are spread over four different ticks. One task is added part way through.
+    static Filter_Scheduler_t sched;
+    static const uint16_t divisors[] = { 1, 10, 10, 100, 10, 10, 1, 4 };
+    Sched_Check_t checks[8]          = { { 0 } };
+    bool sched_ok                    = true;
+    Filter_Sched_Init( &sched, NULL, 0 );
+    for( int i = 0; i < 8; i++ ) {
+        checks[i].p_sched = &sched;
+        checks[i].divisor = divisors[i];
+        if( i < 7 )
+            sched_ok &= Filter_Sched_Add_Callback( &sched, sched_check_run, &checks[i], divisors[i] );
+    }
+    for( int i = 0; i < 1000; i++ )
+        Filter_Sched_Tick( &sched );
+    sched_ok &= Filter_Sched_Add_Callback( &sched, sched_check_run, &checks[7], divisors[7] );
+    for( int i = 0; i < 1000; i++ )
+        Filter_Sched_Tick( &sched );
+
+    uint16_t ten_phases = 0;
+    for( int i = 0; i < 8; i++ ) {
+        uint32_t ticks = ( i < 7 ) ? 2000 : 1000;
+        sched_ok &= checks[i].runs == ticks / checks[i].divisor && checks[i].wrong_tick == 0;
+        if( checks[i].divisor == 10 )
+            ten_phases |= 1u << ( checks[i].first_tick % 10 );
+    }
+    sched_ok &= __builtin_popcount( ten_phases ) == 4;
+
+    total_score++;
+    if( sched_ok ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Sched_Tick: a task ran the wrong number of times, on the wrong tick, or phases were not spread.\n" );
+    }
+
+    // Filter bank and Filter_Value_Block: 64 two-stage channels on 4 workers with small chunks so work is stolen, and
+    // one channel in uneven blocks, must match Filter_Value sample by sample exactly
+    enum { BANK_CHANNELS = 64, BANK_LENGTH = 600 };
+    static Filter_Data_t bank_stages[BANK_CHANNELS][2];
+    static float bank_data[BANK_CHANNELS][BANK_LENGTH];
+    static float block_data[BANK_LENGTH];
+    Filter_Channel_t bank[BANK_CHANNELS];
+    Filter_Data_t bank_ref[2];
+    int bank_mismatch = 0;
+
+    for( int c = 0; c < BANK_CHANNELS; c++ ) {
+        Filter_Init( &bank_stages[c][0], num, den, 4 );
+        Filter_Init( &bank_stages[c][1], num2, den2, 4 );
+        for( int i = 0; i < BANK_LENGTH; i++ )
+            bank_data[c][i] = bank_signal( c, i );
+        bank[c] = ( Filter_Channel_t ){ bank_stages[c], 2, bank_data[c], bank_data[c], BANK_LENGTH };
+    }
+    Filter_Bank_Run( bank, BANK_CHANNELS, 4, 3, NULL );
+
+    for( int c = 0; c < BANK_CHANNELS; c++ ) {
+        Filter_Init( &bank_ref[0], num, den, 4 );
+        Filter_Init( &bank_ref[1], num2, den2, 4 );
+        for( int i = 0; i < BANK_LENGTH; i++ ) {
+            float y = Filter_Value( &bank_ref[1], Filter_Value( &bank_ref[0], bank_signal( c, i ) ) );
+            bank_mismatch += y != bank_data[c][i];
+        }
+    }
+
+    for( int i = 0; i < BANK_LENGTH; i++ )
+        block_data[i] = bank_signal( 0, i );
+    Filter_Init( &bank_ref[0], num2, den2, 4 );
+    for( int start = 0, size = 1; start < BANK_LENGTH; start += size, size = size * 2 + 1 ) {
+        int block = ( start + size > BANK_LENGTH ) ? BANK_LENGTH - start : size;
+        Filter_Value_Block( &bank_ref[0], block_data + start, block_data + start, block );
+    }
+    Filter_Init( &bank_ref[1], num2, den2, 4 );
+    for( int i = 0; i < BANK_LENGTH; i++ )
+        bank_mismatch += Filter_Value( &bank_ref[1], bank_signal( 0, i ) ) != block_data[i];
+
+    total_score++;
+    if( bank_mismatch == 0 ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Bank_Run/Filter_Value_Block: %i outputs differ from Filter_Value.\n", bank_mismatch );
+    }
+
+    // Filter bank pool: the same channels fed in uneven pieces to workers kept across runs must match the one-off run
+    static float pool_data[BANK_CHANNELS][BANK_LENGTH];
+    Filter_Bank_Pool_t bank_pool;
+    Filter_Bank_Stats_t pool_stats;
+    int pool_mismatch = 0;
+
+    for( int c = 0; c < BANK_CHANNELS; c++ ) {
+        Filter_Init( &bank_stages[c][0], num, den, 4 );
+        Filter_Init( &bank_stages[c][1], num2, den2, 4 );
+        for( int i = 0; i < BANK_LENGTH; i++ )
+            pool_data[c][i] = bank_signal( c, i );
+    }
+    Filter_Bank_Pool_Start( &bank_pool, 4 );
+    for( int start = 0, size = 7; start < BANK_LENGTH; start += size, size *= 3 ) {
+        int piece = ( start + size > BANK_LENGTH ) ? BANK_LENGTH - start : size;
+        for( int c = 0; c < BANK_CHANNELS; c++ )
+            bank[c] = ( Filter_Channel_t ){ bank_stages[c], 2, pool_data[c] + start, pool_data[c] + start, piece };
+        Filter_Bank_Pool_Run( &bank_pool, bank, BANK_CHANNELS, 3, &pool_stats );
+        pool_mismatch += pool_stats.threads != 4;
+    }
+    Filter_Bank_Pool_Stop( &bank_pool );
+
+    for( int c = 0; c < BANK_CHANNELS; c++ )
+        for( int i = 0; i < BANK_LENGTH; i++ )
+            pool_mismatch += pool_data[c][i] != bank_data[c][i];
+
+    total_score++;
+    if( pool_mismatch == 0 ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Bank_Pool_Run: %i outputs or runs differ from Filter_Bank_Run.\n", pool_mismatch );
+    }
+
+    // Compact filters: FILTER_SIZE and Filter_Size agree, orders 1 and 255 match Filter_Value with the same leading
+    // coefficients (the rest zero for order 255, past where Filter_Data_t can go), and a 255 sample delay is exact
+    static float compact_num[256], compact_den[256];
+    static uint8_t compact_small[FILTER_SIZE( 1 )] __attribute__( ( aligned( 4 ) ) );
+    static uint8_t compact_large[FILTER_SIZE( 255 )] __attribute__( ( aligned( 4 ) ) );
+    float order1_num[] = { 0.3f, 0.2f }, order1_den[] = { 1.0f, -0.5f };
+    Filter_Data_t compact_ref[2];
+    int compact_mismatch = 0;
+
+    compact_mismatch += Filter_Size( 0 ) != FILTER_SIZE( 0 ) || Filter_Size( 1 ) != FILTER_SIZE( 1 ) || Filter_Size( 255 ) != FILTER_SIZE( 255 );
+    for( int i = 0; i <= 4; i++ ) {
+        compact_num[i] = num2[i];
+        compact_den[i] = den2[i];
+    }
+    Filter_Compact_t* p_small = Filter_Compact_Init( compact_small, order1_num, order1_den, 1 );
+    Filter_Compact_t* p_large = Filter_Compact_Init( compact_large, compact_num, compact_den, 255 );
+    Filter_Init( &compact_ref[0], order1_num, order1_den, 1 );
+    Filter_Init( &compact_ref[1], num2, den2, 4 );
+    for( int i = 0; i < 600; i++ ) {
+        compact_mismatch += Filter_Compact_Value( p_small, bank_signal( 0, i ) ) != Filter_Value( &compact_ref[0], bank_signal( 0, i ) );
+        compact_mismatch += Filter_Compact_Value( p_large, bank_signal( 1, i ) ) != Filter_Value( &compact_ref[1], bank_signal( 1, i ) );
+    }
+
+    for( int i = 0; i < 256; i++ )
+        compact_num[i] = compact_den[i] = 0;
+    compact_num[255] = compact_den[0] = 1;
+    p_large          = Filter_Compact_Init( compact_large, compact_num, compact_den, 255 );
+    for( int i = 0; i < 600; i++ )
+        compact_mismatch += Filter_Compact_Value( p_large, bank_signal( 2, i ) ) != ( ( i < 255 ) ? 0.0f : bank_signal( 2, i - 255 ) );
+    compact_mismatch += Filter_Compact_Last_Output( p_large ) != bank_signal( 2, 599 - 255 );
+
+    total_score++;
+    if( compact_mismatch == 0 ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Compact_Value/Filter_Size: %i sizes or outputs differ from Filter_Value.\n", compact_mismatch );
+    }
+
+    // Shared coefficients: reloading a referenced set keeps its reference count
+    Filter_Coeffs_t shared_coeffs;
+    Filter_Shared_t shared_a, shared_b;
+    Filter_Coeffs_Init( &shared_coeffs, num, den, 4 );
+    Filter_Shared_Init( &shared_a, &shared_coeffs );
+    Filter_Shared_Init( &shared_b, &shared_coeffs );
+    Filter_Coeffs_Load( &shared_coeffs, num2, den2, 4 );
+    uint16_t loaded_count = shared_coeffs.ref_count;
+    Filter_Shared_Release( &shared_a );
+    Filter_Shared_Release( &shared_b );
+
+    total_score++;
+    if( loaded_count == 2 && shared_coeffs.ref_count == 0 ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Coeffs_Load: reference count %u after reload, %u after release, should be 2 and 0.\n", loaded_count, shared_coeffs.ref_count );
+    }
+
+    // Shared coefficients: two interleaved channels on one set must each match Filter_Value on their own signal, so
+    // the set holds only coefficients and every channel keeps its own history
+    Filter_Data_t shared_ref[2];
+    int shared_mismatch = 0;
+    Filter_Coeffs_Init( &shared_coeffs, num, den, 4 );
+    Filter_Shared_Init( &shared_a, &shared_coeffs );
+    Filter_Shared_Init( &shared_b, &shared_coeffs );
+    Filter_Init( &shared_ref[0], num, den, 4 );
+    Filter_Init( &shared_ref[1], num, den, 4 );
+    for( int i = 0; i < 400; i++ ) {
+        shared_mismatch += Filter_Shared_Value( &shared_a, bank_signal( 0, i ) ) != Filter_Value( &shared_ref[0], bank_signal( 0, i ) );
+        shared_mismatch += Filter_Shared_Value( &shared_b, bank_signal( 1, i ) ) != Filter_Value( &shared_ref[1], bank_signal( 1, i ) );
+    }
+    shared_mismatch += Filter_Shared_Last_Output( &shared_a ) != Filter_Last_Output( &shared_ref[0] );
+    Filter_Shared_Release( &shared_a );
+    Filter_Shared_Release( &shared_b );
+
+    total_score++;
+    if( shared_mismatch == 0 ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Shared_Value: %i outputs of two channels on one set differ from Filter_Value.\n", shared_mismatch );
+    }
+
+    // Sample files: a three channel CSV converted and filtered per channel must match Filter_Value, a channel past the
+    // last must be refused, and a CSV line longer than the line buffer, or a CSV without numbers, must fail the conversion
+    enum { SAMPLES_FRAMES = 300 };
+    char samples_csv[64], samples_bin[64];
+    static float samples_out[SAMPLES_FRAMES];
+    Filter_Samples_Reader_t samples_reader;
+    bool samples_ok = true;
+
+    snprintf( samples_csv, sizeof( samples_csv ), "/tmp/disc_filter_%d.csv", (int)getpid() );
+    snprintf( samples_bin, sizeof( samples_bin ), "/tmp/disc_filter_%d.fsmp", (int)getpid() );
+    FILE* p_samples_csv = fopen( samples_csv, "w" );
+    samples_ok &= p_samples_csv != NULL;
+    if( samples_ok ) {
+        fprintf( p_samples_csv, "a,b,c\n" );
+        for( int i = 0; i < SAMPLES_FRAMES; i++ )
+            fprintf( p_samples_csv, "%.9g, %.9g, %.9g\n", bank_signal( 0, i ), bank_signal( 1, i ), bank_signal( 2, i ) );
+        fclose( p_samples_csv );
+    }
+    samples_ok &= Filter_Samples_From_CSV( samples_csv, samples_bin, 1000.0f ) == SAMPLES_FRAMES;
+    samples_ok &= Filter_Samples_Open( &samples_reader, samples_bin );
+    if( samples_ok ) {
+        samples_ok &= samples_reader.channel_count == 3 && samples_reader.frame_count == SAMPLES_FRAMES;
+        Filter_Init( &bank_ref[0], num, den, 4 );
+        Filter_Init( &bank_ref[1], num, den, 4 );
+        samples_ok &= Filter_Samples_Filter( &samples_reader, 1, &bank_ref[0], samples_out );
+        for( int i = 0; i < SAMPLES_FRAMES; i++ )
+            samples_ok &= samples_out[i] == Filter_Value( &bank_ref[1], bank_signal( 1, i ) );
+        samples_ok &= !Filter_Samples_Filter( &samples_reader, 3, &bank_ref[0], samples_out );
+        Filter_Samples_Release( &samples_reader );
+    }
+
+    p_samples_csv = fopen( samples_csv, "w" );
+    if( p_samples_csv != NULL ) {
+        // padded so that a 4095 character read splits the long line into two well formed two value frames
+        fprintf( p_samples_csv, "1, 2\n%4090s5, 6 7, 8\n3, 4\n", "" );
+        fclose( p_samples_csv );
+    }
+    samples_ok &= p_samples_csv != NULL && Filter_Samples_From_CSV( samples_csv, samples_bin, 1000.0f ) == -1;
+    unlink( samples_bin );
+
+    // a header without any numeric line has no channel count, so no sample file is written
+    p_samples_csv = fopen( samples_csv, "w" );
+    if( p_samples_csv != NULL ) {
+        fprintf( p_samples_csv, "time, value\n" );
+        fclose( p_samples_csv );
+    }
+    samples_ok &= p_samples_csv != NULL && Filter_Samples_From_CSV( samples_csv, samples_bin, 1000.0f ) == -1 && access( samples_bin, F_OK ) != 0;
+    unlink( samples_csv );
+
+    total_score++;
+    if( samples_ok ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Samples: a channel differs from Filter_Value, a bad channel was accepted, or a long CSV line was split.\n" );
+    }
+
+    // Coefficient hot-swap: hammer publishes from another thread while filtering
+    static Filter_Coeff_Slot_t slot;
+    Filter_Shared_t swapped;
+    float num0[] = { 0, 0, 0, 0, 0 };
+    float den0[] = { 1, 0, 0, 0, 0 };
+    Filter_Slot_Init( &slot, num0, den0, 4 );
+    Filter_Shared_Init( &swapped, Filter_Slot_Acquire( &slot ) );
+
+    pthread_t writer;
+    atomic_store( &hotswap_done, false );
+    pthread_create( &writer, NULL, hotswap_writer, &slot );
+
+    int torn        = 0;
+    int swaps       = 0;
+    float last_coef = 0;
+    for( int i = 0; i < 1000000; i++ ) {
+        Filter_Slot_Value( &swapped, &slot, 1 );
+
+        const Filter_Coeffs_t* p_used = swapped.p_coeffs;
+        float coef                    = rb_get_F( &p_used->numerator, 0 );
+        for( int j = 1; j <= 4; j++ )
+            torn += rb_get_F( &p_used->numerator, j ) != coef;
+        swaps += coef != last_coef;
+        last_coef = coef;
+    }
+
+    atomic_store( &hotswap_done, true );
+    pthread_join( writer, NULL );
+
+    total_score++;
+    if( torn == 0 && swaps > 0 ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Slot_Value: %i torn coefficient reads over %i swaps.\n", torn, swaps );
+    }
+
+    // a set published while the filter runs is used from the very next output: a gain of 2 with no feedback
+    float gain_num[] = { 2, 0, 0, 0, 0 };
+    Filter_Slot_Value( &swapped, &slot, 1 );  // picks up whatever the writer left pending
+    bool published  = Filter_Slot_Publish( &slot, gain_num, den0, 4 );
+    float gain_out  = Filter_Slot_Value( &swapped, &slot, 3 );
+    float gain_next = Filter_Slot_Value( &swapped, &slot, -1.5f );
+
+    total_score++;
+    if( published && gain_out == 6.0f && gain_next == -3.0f ) {
+        running_score++;
+    } else {
+        printf( "Error in Filter_Slot_Publish: published coefficients gave %f and %f, should be 6 and -3.\n", gain_out, gain_next );
+    }
+
     printf( "Testing Done!\n\tScore %i / %i: %2.2f%%\n", running_score, total_score, 100.0 * running_score / total_score );
 
     return 0;
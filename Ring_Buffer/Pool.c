@@ -0,0 +1,117 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Pool.h"
+
+#include <string.h>  // for memset
+
+#define POOL_BIT( index ) ( (uint8_t)( 1u << ( ( index ) & 7 ) ) )
+
+/* Initialization */
+bool Pool_Init( Pool_t* p_pool, void* p_storage, uint16_t block_size, uint16_t count, uint8_t* p_in_use )
+{
+    // a freed block holds the free-list link, so it must fit one
+    bool ok = block_size >= sizeof( void* );
+
+    // blocks are handed out in order from the start of storage until the first free, so there is no list to build
+    p_pool->p_storage   = (uint8_t*)p_storage;
+    p_pool->p_in_use    = p_in_use;
+    p_pool->p_free      = NULL;
+    p_pool->block_size  = block_size;
+    p_pool->capacity    = ok ? count : 0;
+    p_pool->next_unused = 0;
+    p_pool->in_use      = 0;
+    p_pool->peak        = 0;
+    p_pool->failed      = 0;
+
+    if( ok )
+        memset( p_in_use, 0, POOL_BITMAP_BYTES( count ) );
+    return ok;
+}
+
+/* Allocate a block */
+void* Pool_Alloc( Pool_t* p_pool )
+{
+    void* p_block;
+
+    // reuse released blocks before touching blocks that have never been handed out
+    if( p_pool->p_free != NULL ) {
+        p_block        = p_pool->p_free;
+        p_pool->p_free = *(void**)p_block;
+    } else if( p_pool->next_unused < p_pool->capacity ) {
+        p_block = p_pool->p_storage + (size_t)p_pool->next_unused * p_pool->block_size;
+        p_pool->next_unused++;
+    } else {
+        if( p_pool->failed < UINT16_MAX )
+            p_pool->failed++;
+        return NULL;
+    }
+
+    uint16_t index = ( (uint8_t*)p_block - p_pool->p_storage ) / p_pool->block_size;
+    p_pool->p_in_use[index >> 3] |= POOL_BIT( index );
+
+    p_pool->in_use++;
+    if( p_pool->in_use > p_pool->peak )
+        p_pool->peak = p_pool->in_use;
+
+    return p_block;
+}
+
+/* Release a block */
+void Pool_Free( Pool_t* p_pool, void* p_block )
+{
+    uint8_t* p_byte = (uint8_t*)p_block;
+
+    // ignore NULL and anything that is not the start of a block handed out by this pool
+    if( p_byte < p_pool->p_storage || p_byte >= p_pool->p_storage + (size_t)p_pool->next_unused * p_pool->block_size )
+        return;
+    if( ( p_byte - p_pool->p_storage ) % p_pool->block_size != 0 )
+        return;
+
+    // a block already on the free list would make the list cyclic and be handed out twice
+    uint16_t index = ( p_byte - p_pool->p_storage ) / p_pool->block_size;
+    if( !( p_pool->p_in_use[index >> 3] & POOL_BIT( index ) ) )
+        return;
+    p_pool->p_in_use[index >> 3] &= (uint8_t)~POOL_BIT( index );
+
+    *(void**)p_block = p_pool->p_free;
+    p_pool->p_free   = p_block;
+    p_pool->in_use--;
+}
+
+/* Occupancy statistics */
+void Pool_Get_Stats( const Pool_t* p_pool, Pool_Stats_t* p_stats )
+{
+    p_stats->block_size = p_pool->block_size;
+    p_stats->capacity   = p_pool->capacity;
+    p_stats->in_use     = p_pool->in_use;
+    p_stats->peak       = p_pool->peak;
+    p_stats->failed     = p_pool->failed;
+}
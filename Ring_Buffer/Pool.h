@@ -0,0 +1,115 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/* Pool.h
+ *
+ * A fixed-block pool allocator for objects that are created and destroyed often, such as Filter_Data_t,
+ * Ring_Buffer_Float_t and Ring_Buffer_Byte_t. All blocks live in one caller-provided array and allocation is O(1). No
+ * heap is used, so the pool works from static storage on AVR_MCU builds.
+ *
+ * Free blocks are chained through their own first bytes, so a block is never smaller than a pointer and Pool_Init
+ * refuses a smaller block_size. Released blocks are reused most recently freed first. A bitmap with one bit per block
+ * marks the blocks in use, so Pool_Free refuses a block that is already free in O(1) and a double free cannot make two
+ * allocations share a block. The POOL_STORAGE macro declares a correctly sized and aligned array for a type, together
+ * with its bitmap:
+ *
+ *  POOL_STORAGE( filter_blocks, Filter_Data_t, 32 );
+ *  Pool_t filter_pool;
+ *  POOL_INIT( &filter_pool, filter_blocks );
+ *  Filter_Data_t* p_filt = Pool_Alloc( &filter_pool );
+ *  ...
+ *  Pool_Free( &filter_pool, p_filt );
+ *
+ * Functions implemented are as follows:
+ *
+ * Pool_Init        <-- Sets up a pool over an array of equally sized blocks and its in-use bitmap
+ * Pool_Alloc       <-- Returns a free block or NULL if the pool is exhausted
+ * Pool_Free        <-- Returns a block to the pool
+ * Pool_Get_Stats   <-- Reports occupancy, peak use and failed allocations
+ * */
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>  // for NULL and size_t
+#include <stdint.h>  // for uint8_t type
+
+// bytes of in-use bitmap for count blocks
+#define POOL_BITMAP_BYTES( count ) ( ( (size_t)( count ) + 7 ) / 8 )
+
+// Declares a static array of count blocks, each able to hold a type or a free-list link, and name_in_use, its bitmap.
+#define POOL_STORAGE( name, type, count )                      \
+    static uint8_t name##_in_use[POOL_BITMAP_BYTES( count )];  \
+    static union {                                             \
+        type object;                                           \
+        void* p_next;                                          \
+    } name[count]
+
+// Initializes a pool over an array declared with POOL_STORAGE, passed by its name.
+#define POOL_INIT( p_pool, storage ) \
+    Pool_Init( ( p_pool ), ( storage ), sizeof( ( storage )[0] ), sizeof( storage ) / sizeof( ( storage )[0] ), storage##_in_use )
+
+// data structure for a block pool
+typedef struct {
+    uint8_t* p_storage;
+    uint8_t* p_in_use;     // one bit per block, set while the block is allocated
+    void* p_free;          // head of the list of released blocks
+    uint16_t block_size;
+    uint16_t capacity;
+    uint16_t next_unused;  // blocks at and above this index have never been handed out
+    uint16_t in_use;
+    uint16_t peak;
+    uint16_t failed;       // saturates at UINT16_MAX
+} Pool_t;
+
+// occupancy statistics reported by Pool_Get_Stats
+typedef struct {
+    uint16_t block_size;
+    uint16_t capacity;
+    uint16_t in_use;
+    uint16_t peak;
+    uint16_t failed;
+} Pool_Stats_t;
+
+/* Initialization. block_size must be at least sizeof( void* ) and a multiple of the object alignment, and p_in_use
+ * must hold POOL_BITMAP_BYTES( count ) bytes. Returns false, leaving an empty pool, if block_size is too small. */
+bool Pool_Init( Pool_t* p_pool, void* p_storage, uint16_t block_size, uint16_t count, uint8_t* p_in_use );
+
+/* Allocate a block, NULL when the pool is exhausted */
+void* Pool_Alloc( Pool_t* p_pool );
+
+/* Release a block previously returned by Pool_Alloc. Pointers outside the pool, not at the start of a block, or to a
+ * block that is already free are ignored. */
+void Pool_Free( Pool_t* p_pool, void* p_block );
+
+/* Occupancy statistics */
+void Pool_Get_Stats( const Pool_t* p_pool, Pool_Stats_t* p_stats );
+
+#endif
@@ -30,7 +30,13 @@
 
 #include "Ring_Buffer.h"
 
-#include <stdio.h>  // required for the printf in rb_print_data_X functions
+#include <stdio.h>   // required for the printf in rb_print_data_X functions
+#include <string.h>  // for memchr and memcmp in rb_find_B and rb_find_seq_B
+
+#ifndef AVR_MCU
+#    include <errno.h>    // for ENOBUFS from rb_read_fd_B
+#    include <sys/uio.h>  // for readv and writev in rb_read_fd_B and rb_write_fd_B
+#endif
 
 // define constant masks for use later based on length chosen
 // static makes these global scope only to this c file
@@ -225,7 +231,171 @@ void rb_set_B( Ring_Buffer_Byte_t* p_buf, uint8_t index, uint8_t value )
     p_buf->buffer[rb_index] = value;
 }
 
+/* contiguous access */
+uint8_t rb_read_span_F( const Ring_Buffer_Float_t* p_buf, const float** pp_data )
+{
+    // active elements run from start to end, or from start to the end of storage if they wrap
+    *pp_data = &p_buf->buffer[p_buf->start_index];
+    if( p_buf->end_index >= p_buf->start_index )
+        return p_buf->end_index - p_buf->start_index;
+    else
+        return RB_LENGTH_F - p_buf->start_index;
+}
+uint8_t rb_read_span_B( const Ring_Buffer_Byte_t* p_buf, const uint8_t** pp_data )
+{
+    *pp_data = &p_buf->buffer[p_buf->start_index];
+    if( p_buf->end_index >= p_buf->start_index )
+        return p_buf->end_index - p_buf->start_index;
+    else
+        return RB_LENGTH_B - p_buf->start_index;
+}
+
+void rb_consume_F( Ring_Buffer_Float_t* p_buf, uint8_t count )
+{
+    // never move start past end
+    if( count > rb_length_F( p_buf ) )
+        count = rb_length_F( p_buf );
+    p_buf->start_index = ( p_buf->start_index + count ) & RB_MASK_F;
+}
+void rb_consume_B( Ring_Buffer_Byte_t* p_buf, uint8_t count )
+{
+    if( count > rb_length_B( p_buf ) )
+        count = rb_length_B( p_buf );
+    p_buf->start_index = ( p_buf->start_index + count ) & RB_MASK_B;
+}
+
+uint8_t rb_write_span_F( Ring_Buffer_Float_t* p_buf, float** pp_data )
+{
+    // one slot always stays empty so a full buffer is distinguishable from an empty one
+    uint8_t free_count = RB_MASK_F - rb_length_F( p_buf );
+    uint16_t to_wrap   = RB_LENGTH_F - p_buf->end_index;  // may be 256
+
+    *pp_data = &p_buf->buffer[p_buf->end_index];
+    return ( free_count < to_wrap ) ? free_count : to_wrap;
+}
+uint8_t rb_write_span_B( Ring_Buffer_Byte_t* p_buf, uint8_t** pp_data )
+{
+    uint8_t free_count = RB_MASK_B - rb_length_B( p_buf );
+    uint16_t to_wrap   = RB_LENGTH_B - p_buf->end_index;  // may be 256
+
+    *pp_data = &p_buf->buffer[p_buf->end_index];
+    return ( free_count < to_wrap ) ? free_count : to_wrap;
+}
+
+void rb_commit_F( Ring_Buffer_Float_t* p_buf, uint8_t count )
+{
+    // never move end onto start
+    if( count > RB_MASK_F - rb_length_F( p_buf ) )
+        count = RB_MASK_F - rb_length_F( p_buf );
+    p_buf->end_index = ( p_buf->end_index + count ) & RB_MASK_F;
+}
+void rb_commit_B( Ring_Buffer_Byte_t* p_buf, uint8_t count )
+{
+    if( count > RB_MASK_B - rb_length_B( p_buf ) )
+        count = RB_MASK_B - rb_length_B( p_buf );
+    p_buf->end_index = ( p_buf->end_index + count ) & RB_MASK_B;
+}
+
+/* search */
+// first occurrence of value at or after active index from, or -1
+static int16_t rb_find_from_B( const Ring_Buffer_Byte_t* p_buf, uint8_t value, uint8_t from )
+{
+    uint8_t length = rb_length_B( p_buf );
+    if( from >= length )
+        return -1;
+
+    // the active elements from 'from' on run to the end of storage, then continue at its start
+    uint8_t position    = ( p_buf->start_index + from ) & RB_MASK_B;
+    uint16_t to_wrap    = RB_LENGTH_B - position;  // may be 256
+    uint8_t remaining   = length - from;
+    uint8_t first       = ( remaining < to_wrap ) ? remaining : to_wrap;
+    const uint8_t* p_at = memchr( &p_buf->buffer[position], value, first );
+    if( p_at != NULL )
+        return from + ( p_at - &p_buf->buffer[position] );
+
+    p_at = memchr( p_buf->buffer, value, remaining - first );
+    return ( p_at != NULL ) ? from + first + ( p_at - p_buf->buffer ) : -1;
+}
+
+int16_t rb_find_B( const Ring_Buffer_Byte_t* p_buf, uint8_t value )
+{
+    return rb_find_from_B( p_buf, value, 0 );
+}
+
+int16_t rb_find_seq_B( const Ring_Buffer_Byte_t* p_buf, const uint8_t* p_pattern, uint8_t length )
+{
+    uint8_t active = rb_length_B( p_buf );
+    if( length == 0 )
+        return ( active > 0 ) ? 0 : -1;  // an empty pattern matches at the first element, if there is one
+
+    // jump between occurrences of the first pattern byte, then compare the rest
+    for( int16_t index = rb_find_from_B( p_buf, p_pattern[0], 0 ); index >= 0 && index + length <= active;
+         index = rb_find_from_B( p_buf, p_pattern[0], index + 1 ) ) {
+        uint8_t position = ( p_buf->start_index + index ) & RB_MASK_B;
+        uint16_t to_wrap = RB_LENGTH_B - position;
+        uint8_t first    = ( length < to_wrap ) ? length : to_wrap;
+
+        if( memcmp( &p_buf->buffer[position], p_pattern, first ) == 0 && memcmp( p_buf->buffer, p_pattern + first, length - first ) == 0 )
+            return index;
+    }
+
+    return -1;
+}
+
 #ifndef AVR_MCU
+/* file descriptor access */
+int rb_read_fd_B( Ring_Buffer_Byte_t* p_buf, int fd )
+{
+    // free space runs from end to the end of storage, then from the start of storage up to one before start
+    uint8_t free_count = RB_MASK_B - rb_length_B( p_buf );
+    uint16_t to_wrap   = RB_LENGTH_B - p_buf->end_index;  // may be 256
+    struct iovec segments[2];
+    int segment_count = 1;
+
+    // a 0 return must only ever mean end of file, so a full ring is an error of its own
+    if( free_count == 0 ) {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    segments[0].iov_base = &p_buf->buffer[p_buf->end_index];
+    segments[0].iov_len  = ( free_count < to_wrap ) ? free_count : to_wrap;
+    if( free_count > to_wrap ) {
+        segments[1].iov_base = &p_buf->buffer[0];
+        segments[1].iov_len  = free_count - to_wrap;
+        segment_count        = 2;
+    }
+
+    ssize_t got = readv( fd, segments, segment_count );
+    if( got > 0 )
+        p_buf->end_index = ( p_buf->end_index + got ) & RB_MASK_B;
+    return (int)got;
+}
+
+int rb_write_fd_B( Ring_Buffer_Byte_t* p_buf, int fd )
+{
+    uint8_t length   = rb_length_B( p_buf );
+    uint16_t to_wrap = RB_LENGTH_B - p_buf->start_index;
+    struct iovec segments[2];
+    int segment_count = 1;
+
+    if( length == 0 )
+        return 0;
+
+    segments[0].iov_base = &p_buf->buffer[p_buf->start_index];
+    segments[0].iov_len  = ( length < to_wrap ) ? length : to_wrap;
+    if( length > to_wrap ) {
+        segments[1].iov_base = &p_buf->buffer[0];
+        segments[1].iov_len  = length - to_wrap;
+        segment_count        = 2;
+    }
+
+    ssize_t put = writev( fd, segments, segment_count );
+    if( put > 0 )
+        p_buf->start_index = ( p_buf->start_index + put ) & RB_MASK_B;
+    return (int)put;
+}
+
 /*
  * The below functions are provided to help you debug. They print out the length, start and end index, active elements,
  * and the contents of the buffer.
@@ -48,6 +48,14 @@
  * rb_pop_front_X   <-- Removes and returns the first element
  * rb_get_X         <-- Returns an desired element from within the buffer
  * rb_set_X         <-- Sets a desired element within the buffer
+ * rb_read_span_X   <-- Returns a pointer to the longest contiguous run of active elements at the start
+ * rb_consume_X     <-- Removes elements from the start after they were read through a span
+ * rb_write_span_X  <-- Returns a pointer to the longest contiguous run of free space at the end
+ * rb_commit_X      <-- Adds elements to the end after they were written through a span
+ * rb_find_B        <-- Returns the index of the first occurrence of a byte, searching across the wrap point
+ * rb_find_seq_B    <-- Returns the index of the first occurrence of a byte sequence, searching across the wrap point
+ * rb_read_fd_B     <-- Fills the free space from a file descriptor with one readv
+ * rb_write_fd_B    <-- Drains the active elements to a file descriptor with one writev
  *
  * Code Skeleton provided by Dr Petruska for MEGN 540, Mechatronics
  * Code Details Provided by:  [ YOUR NAME ]
@@ -123,4 +131,37 @@ uint8_t rb_get_B( const Ring_Buffer_Byte_t* p_buf, uint8_t index );
 void rb_set_F( Ring_Buffer_Float_t* p_buf, uint8_t index, float value );
 void rb_set_B( Ring_Buffer_Byte_t* p_buf, uint8_t index, uint8_t value );
 
+/* contiguous access - lets bulk consumers and producers work on the storage directly instead of
+   element by element. A span never crosses the wrap point, so a full transfer may take two spans.
+   Unlike push_back, writing through a span never overwrites active elements.
+*/
+uint8_t rb_read_span_F( const Ring_Buffer_Float_t* p_buf, const float** pp_data );
+uint8_t rb_read_span_B( const Ring_Buffer_Byte_t* p_buf, const uint8_t** pp_data );
+
+void rb_consume_F( Ring_Buffer_Float_t* p_buf, uint8_t count );
+void rb_consume_B( Ring_Buffer_Byte_t* p_buf, uint8_t count );
+
+uint8_t rb_write_span_F( Ring_Buffer_Float_t* p_buf, float** pp_data );
+uint8_t rb_write_span_B( Ring_Buffer_Byte_t* p_buf, uint8_t** pp_data );
+
+void rb_commit_F( Ring_Buffer_Float_t* p_buf, uint8_t count );
+void rb_commit_B( Ring_Buffer_Byte_t* p_buf, uint8_t count );
+
+/* search - scans each contiguous segment with memchr rather than calling rb_get_B per element.
+   Returns the index of the match within the active elements, as used by rb_get_B, or -1 if there is none.
+   An empty sequence matches at index 0 unless the ring is empty.
+*/
+int16_t rb_find_B( const Ring_Buffer_Byte_t* p_buf, uint8_t value );
+int16_t rb_find_seq_B( const Ring_Buffer_Byte_t* p_buf, const uint8_t* p_pattern, uint8_t length );
+
+#ifndef AVR_MCU  // needs POSIX readv/writev
+/* file descriptor access - moves bytes straight between the ring storage and fd, passing the (up to two)
+   contiguous segments to a single readv or writev. Returns the number of bytes moved, or -1 with errno set.
+   Reading never overwrites active elements: on a full ring rb_read_fd_B returns -1 with errno = ENOBUFS without
+   calling readv, so a return of 0 always means end of file. rb_write_fd_B returns 0 for an empty ring.
+*/
+int rb_read_fd_B( Ring_Buffer_Byte_t* p_buf, int fd );
+int rb_write_fd_B( Ring_Buffer_Byte_t* p_buf, int fd );
+#endif
+
 #endif
@@ -0,0 +1,177 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Ring_Buffer_Broadcast.h"
+
+static const uint64_t RB_MASK_BCAST = RB_LENGTH_BCAST - 1;
+
+// Returns the cursor of the slowest active reader, or end if there are none.
+static uint64_t slowest_reader( Ring_Buffer_Broadcast_Float_t* p_buf, uint64_t end )
+{
+    uint64_t min = end;
+    for( int r = 0; r < RB_BCAST_MAX_READERS; r++ ) {
+        if( !atomic_load_explicit( &p_buf->readers[r].active, memory_order_acquire ) )
+            continue;
+        uint64_t cursor = atomic_load_explicit( &p_buf->readers[r].cursor, memory_order_acquire );
+        if( cursor < min )
+            min = cursor;
+    }
+    return min;
+}
+
+// Moves a lapped reader up to the oldest element still in the buffer, counting what it skipped.
+static uint64_t catch_up( Rb_Bcast_Reader_t* p_reader, uint64_t cursor, uint64_t end )
+{
+    if( end - cursor > RB_LENGTH_BCAST ) {
+        p_reader->missed += end - cursor - RB_LENGTH_BCAST;
+        cursor = end - RB_LENGTH_BCAST;
+    }
+    return cursor;
+}
+
+/* Initialization */
+void rb_bcast_initialize_F( Ring_Buffer_Broadcast_Float_t* p_buf, Rb_Bcast_Policy_t policy )
+{
+    atomic_init( &p_buf->end_seq, 0 );
+    p_buf->cached_min = 0;
+    p_buf->policy     = policy;
+
+    for( int r = 0; r < RB_BCAST_MAX_READERS; r++ ) {
+        atomic_init( &p_buf->readers[r].cursor, 0 );
+        atomic_init( &p_buf->readers[r].claimed, false );
+        atomic_init( &p_buf->readers[r].active, false );
+        p_buf->readers[r].missed = 0;
+    }
+}
+
+/* Reader registration */
+int rb_bcast_add_reader_F( Ring_Buffer_Broadcast_Float_t* p_buf )
+{
+    for( int r = 0; r < RB_BCAST_MAX_READERS; r++ ) {
+        Rb_Bcast_Reader_t* p_reader = &p_buf->readers[r];
+
+        // only the adder that wins the claim writes the slot, a loser moves on without touching it
+        bool expected = false;
+        if( atomic_load( &p_reader->claimed ) || !atomic_compare_exchange_strong( &p_reader->claimed, &expected, true ) )
+            continue;
+
+        // set the cursor before activating so the producer never sees a stale position for this reader
+        atomic_store( &p_reader->cursor, atomic_load( &p_buf->end_seq ) );
+        p_reader->missed = 0;
+        atomic_store( &p_reader->active, true );
+
+        // elements pushed while registering are simply skipped, start at the current end
+        atomic_store( &p_reader->cursor, atomic_load( &p_buf->end_seq ) );
+        return r;
+    }
+    return -1;
+}
+
+void rb_bcast_remove_reader_F( Ring_Buffer_Broadcast_Float_t* p_buf, int reader )
+{
+    atomic_store_explicit( &p_buf->readers[reader].active, false, memory_order_release );
+    atomic_store_explicit( &p_buf->readers[reader].claimed, false, memory_order_release );
+}
+
+/* Producer */
+bool rb_bcast_push_back_F( Ring_Buffer_Broadcast_Float_t* p_buf, float value )
+{
+    uint64_t end = atomic_load_explicit( &p_buf->end_seq, memory_order_relaxed );
+
+    if( p_buf->policy == RB_BCAST_BLOCK && end - p_buf->cached_min >= RB_LENGTH_BCAST ) {
+        // only rescan the readers when the cached slowest position says the buffer is full
+        p_buf->cached_min = slowest_reader( p_buf, end );
+        if( end - p_buf->cached_min >= RB_LENGTH_BCAST )
+            return false;
+    }
+
+    // keep the previous end_seq store ahead of this slot store, lagging readers rely on that order to detect an
+    // overwrite in progress
+    atomic_thread_fence( memory_order_release );
+    atomic_store_explicit( &p_buf->buffer[end & RB_MASK_BCAST], value, memory_order_relaxed );
+    atomic_store_explicit( &p_buf->end_seq, end + 1, memory_order_release );
+
+    return true;
+}
+
+/* Readers */
+uint32_t rb_bcast_length_F( Ring_Buffer_Broadcast_Float_t* p_buf, int reader )
+{
+    uint64_t end    = atomic_load_explicit( &p_buf->end_seq, memory_order_acquire );
+    uint64_t cursor = atomic_load_explicit( &p_buf->readers[reader].cursor, memory_order_relaxed );
+    uint64_t length = end - cursor;
+    return ( length > RB_LENGTH_BCAST ) ? RB_LENGTH_BCAST : length;
+}
+
+uint32_t rb_bcast_read_F( Ring_Buffer_Broadcast_Float_t* p_buf, int reader, float* p_data, uint32_t count )
+{
+    Rb_Bcast_Reader_t* p_reader = &p_buf->readers[reader];
+    uint64_t cursor             = atomic_load_explicit( &p_reader->cursor, memory_order_relaxed );
+    uint64_t end                = atomic_load_explicit( &p_buf->end_seq, memory_order_acquire );
+
+    cursor = catch_up( p_reader, cursor, end );
+    if( end - cursor < count )
+        count = end - cursor;
+
+    for( uint32_t i = 0; i < count; i++ )
+        p_data[i] = atomic_load_explicit( &p_buf->buffer[( cursor + i ) & RB_MASK_BCAST], memory_order_relaxed );
+
+    if( p_buf->policy == RB_BCAST_OVERWRITE ) {
+        // anything the producer may have started overwriting during the copy is unreliable, drop it
+        atomic_thread_fence( memory_order_acquire );
+        uint64_t end_now = atomic_load_explicit( &p_buf->end_seq, memory_order_relaxed );
+        uint64_t safe    = ( end_now >= RB_LENGTH_BCAST ) ? end_now - RB_LENGTH_BCAST + 1 : 0;  // oldest slot not being written
+
+        if( safe > cursor ) {
+            uint64_t lost = safe - cursor;
+            if( lost > count )
+                lost = count;
+            // keep the intact tail by shifting it to the front of the caller's array
+            for( uint32_t i = 0; i + lost < count; i++ )
+                p_data[i] = p_data[i + lost];
+            p_reader->missed += lost;
+            cursor += lost;
+            count -= lost;
+        }
+    }
+
+    atomic_store_explicit( &p_reader->cursor, cursor + count, memory_order_release );
+    return count;
+}
+
+bool rb_bcast_pop_front_F( Ring_Buffer_Broadcast_Float_t* p_buf, int reader, float* p_value )
+{
+    return rb_bcast_read_F( p_buf, reader, p_value, 1 ) == 1;
+}
+
+uint64_t rb_bcast_missed_F( const Ring_Buffer_Broadcast_Float_t* p_buf, int reader )
+{
+    return p_buf->readers[reader].missed;
+}
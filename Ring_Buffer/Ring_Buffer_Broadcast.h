@@ -0,0 +1,113 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/* Ring_Buffer_Broadcast.h
+ *
+ * A single producer, multiple consumer float ring buffer in which every reader sees every element. The producer
+ * writes each element once and each reader keeps its own cursor into the shared storage, so one stream can feed a
+ * logger, a controller and a UI without copying it into a ring per consumer.
+ *
+ * The producer publishes a free running 64 bit end sequence. Two policies handle a reader that falls behind:
+ *  - RB_BCAST_BLOCK: the producer tracks the slowest reader and rb_bcast_push_back_F fails while the slowest
+ *    reader is a full buffer behind. Readers never miss data.
+ *  - RB_BCAST_OVERWRITE: the producer never waits. A reader that was lapped skips to the oldest element still
+ *    present and is told how many elements it missed; an element overwritten while it was being read is discarded
+ *    and counted as missed as well.
+ *
+ * Functions implemented are as follows:
+ *
+ * rb_bcast_initialize_F   <-- Initializes the ring buffer for use with a policy, not thread safe
+ * rb_bcast_add_reader_F   <-- Registers a reader, which starts at the next element pushed
+ * rb_bcast_remove_reader_F<-- Unregisters a reader so it no longer holds the producer back
+ * rb_bcast_push_back_F    <-- Producer: appends an element, false if blocked by a slow reader
+ * rb_bcast_length_F       <-- Reader: number of elements waiting for that reader
+ * rb_bcast_pop_front_F    <-- Reader: removes the reader's next element, false if none
+ * rb_bcast_read_F         <-- Reader: removes up to count elements into an array
+ * rb_bcast_missed_F       <-- Reader: total elements the reader has missed
+ *
+ * Requires C11 atomics, so this is not built for AVR_MCU.
+ * */
+#ifndef RING_BUFFER_BROADCAST_H
+#define RING_BUFFER_BROADCAST_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef RB_LENGTH_BCAST
+#    define RB_LENGTH_BCAST 1024  // must be a power of 2
+#endif
+
+#ifndef RB_BCAST_MAX_READERS
+#    define RB_BCAST_MAX_READERS 8
+#endif
+
+#define RB_BCAST_CACHE_LINE 64
+
+typedef enum { RB_BCAST_BLOCK, RB_BCAST_OVERWRITE } Rb_Bcast_Policy_t;
+
+// one reader's position, on its own cache line
+typedef struct {
+    _Alignas( RB_BCAST_CACHE_LINE ) _Atomic uint64_t cursor;  // sequence of the next element to read
+    atomic_bool claimed;  // slot owned by a reader, set before the slot is written
+    atomic_bool active;   // slot seen by the producer, set once the cursor is valid
+    uint64_t missed;
+} Rb_Bcast_Reader_t;
+
+// data structure for a broadcast float ring buffer
+typedef struct {
+    _Alignas( RB_BCAST_CACHE_LINE ) _Atomic uint64_t end_seq;  // elements below this sequence are readable
+    uint64_t cached_min;  // producer's last view of the slowest reader
+    Rb_Bcast_Policy_t policy;
+
+    Rb_Bcast_Reader_t readers[RB_BCAST_MAX_READERS];
+
+    // elements are accessed atomically (plain moves on common targets) since overwrite mode lets the producer write a
+    // slot while a lagging reader reads it
+    _Alignas( RB_BCAST_CACHE_LINE ) _Atomic float buffer[RB_LENGTH_BCAST];
+} Ring_Buffer_Broadcast_Float_t;
+
+/* Initialization */
+void rb_bcast_initialize_F( Ring_Buffer_Broadcast_Float_t* p_buf, Rb_Bcast_Policy_t policy );
+
+/* Reader registration, returns the reader id or -1 if all reader slots are in use */
+int rb_bcast_add_reader_F( Ring_Buffer_Broadcast_Float_t* p_buf );
+void rb_bcast_remove_reader_F( Ring_Buffer_Broadcast_Float_t* p_buf, int reader );
+
+/* Producer */
+bool rb_bcast_push_back_F( Ring_Buffer_Broadcast_Float_t* p_buf, float value );
+
+/* Readers, each reader id used by one thread */
+uint32_t rb_bcast_length_F( Ring_Buffer_Broadcast_Float_t* p_buf, int reader );
+bool rb_bcast_pop_front_F( Ring_Buffer_Broadcast_Float_t* p_buf, int reader, float* p_value );
+uint32_t rb_bcast_read_F( Ring_Buffer_Broadcast_Float_t* p_buf, int reader, float* p_data, uint32_t count );
+uint64_t rb_bcast_missed_F( const Ring_Buffer_Broadcast_Float_t* p_buf, int reader );
+
+#endif
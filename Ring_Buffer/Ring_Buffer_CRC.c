@@ -0,0 +1,185 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Ring_Buffer_CRC.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>  // for memcpy
+
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+#    include <nmmintrin.h>
+#    define RB_CRC_HAVE_SSE42 1
+#else
+#    define RB_CRC_HAVE_SSE42 0
+#endif
+
+#if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#    error "crc_slice8 loads words little-endian"
+#endif
+
+// reflected polynomials, indexed by Rb_Crc_Kind_t
+static const uint32_t crc_polynomials[] = { 0xA001, 0xEDB88320, 0x82F63B78 };
+static const uint32_t crc_initial[]     = { 0xFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+static const uint32_t crc_final_xor[]   = { 0x0000, 0xFFFFFFFF, 0xFFFFFFFF };
+
+// crc_tables[kind][k][b] is the CRC of byte b followed by k zero bytes
+static uint32_t crc_tables[3][8][256];
+static pthread_once_t crc_tables_once = PTHREAD_ONCE_INIT;
+static bool crc_use_sse42;
+
+static void crc_build_tables( void )
+{
+    for( int kind = 0; kind < 3; kind++ ) {
+        for( uint32_t b = 0; b < 256; b++ ) {
+            uint32_t crc = b;
+            for( int bit = 0; bit < 8; bit++ )
+                crc = ( crc >> 1 ) ^ ( ( crc & 1 ) ? crc_polynomials[kind] : 0 );
+            crc_tables[kind][0][b] = crc;
+        }
+        for( int k = 1; k < 8; k++ )
+            for( uint32_t b = 0; b < 256; b++ )
+                crc_tables[kind][k][b] = ( crc_tables[kind][k - 1][b] >> 8 ) ^ crc_tables[kind][0][crc_tables[kind][k - 1][b] & 0xFF];
+    }
+
+#if RB_CRC_HAVE_SSE42
+    crc_use_sse42 = __builtin_cpu_supports( "sse4.2" );
+#endif
+}
+
+#if RB_CRC_HAVE_SSE42
+__attribute__( ( target( "sse4.2" ) ) ) static uint32_t crc32c_sse42( uint32_t crc, const uint8_t* p_data, size_t length )
+{
+    uint64_t crc64 = crc;
+    for( ; length >= 8; p_data += 8, length -= 8 ) {
+        uint64_t word;
+        memcpy( &word, p_data, 8 );
+        crc64 = _mm_crc32_u64( crc64, word );
+    }
+
+    crc = (uint32_t)crc64;
+    while( length-- > 0 )
+        crc = _mm_crc32_u8( crc, *p_data++ );
+    return crc;
+}
+#endif
+
+// slicing-by-8: eight bytes per step through eight tables, then the tail a byte at a time
+static uint32_t crc_slice8( Rb_Crc_Kind_t kind, uint32_t crc, const uint8_t* p_data, size_t length )
+{
+#if RB_CRC_HAVE_SSE42
+    if( kind == RB_CRC32C && crc_use_sse42 )
+        return crc32c_sse42( crc, p_data, length );
+#endif
+
+    uint32_t( *table )[256] = crc_tables[kind];
+    for( ; length >= 8; p_data += 8, length -= 8 ) {
+        uint32_t low, high;
+        memcpy( &low, p_data, 4 );
+        memcpy( &high, p_data + 4, 4 );
+        low ^= crc;  // the tables assume a little-endian load
+        crc = table[7][low & 0xFF] ^ table[6][( low >> 8 ) & 0xFF] ^ table[5][( low >> 16 ) & 0xFF] ^ table[4][low >> 24] ^ table[3][high & 0xFF]
+              ^ table[2][( high >> 8 ) & 0xFF] ^ table[1][( high >> 16 ) & 0xFF] ^ table[0][high >> 24];
+    }
+
+    while( length-- > 0 )
+        crc = ( crc >> 8 ) ^ table[0][( crc ^ *p_data++ ) & 0xFF];
+    return crc;
+}
+
+/* Incremental CRCs */
+void rb_crc_initialize( Rb_Crc_t* p_crc, Rb_Crc_Kind_t kind )
+{
+    pthread_once( &crc_tables_once, crc_build_tables );
+    p_crc->kind  = kind;
+    p_crc->state = crc_initial[kind];
+}
+
+void rb_crc_update( Rb_Crc_t* p_crc, const uint8_t* p_data, size_t length )
+{
+    p_crc->state = crc_slice8( p_crc->kind, p_crc->state, p_data, length );
+}
+
+void rb_crc_update_B( Rb_Crc_t* p_crc, const Ring_Buffer_Byte_t* p_buf, uint8_t index, uint8_t count )
+{
+    uint8_t length = rb_length_B( p_buf );
+    if( index >= length )
+        return;
+    if( count > length - index )
+        count = length - index;
+
+    // the range runs to the end of storage at most, then continues at its start
+    uint8_t position = ( p_buf->start_index + index ) & ( RB_LENGTH_B - 1 );
+    uint16_t to_wrap = RB_LENGTH_B - position;  // may be 256
+    uint8_t first    = ( count < to_wrap ) ? count : to_wrap;
+
+    rb_crc_update( p_crc, &p_buf->buffer[position], first );
+    rb_crc_update( p_crc, p_buf->buffer, count - first );
+}
+
+bool rb_crc_push_back_B( Rb_Crc_t* p_crc, Ring_Buffer_Byte_t* p_buf, uint8_t value )
+{
+    // rb_push_back_B would drop the oldest byte, which the CRC already covers
+    if( rb_length_B( p_buf ) == RB_LENGTH_B - 1 )
+        return false;
+
+    rb_push_back_B( p_buf, value );
+    p_crc->state = ( p_crc->state >> 8 ) ^ crc_tables[p_crc->kind][0][( p_crc->state ^ value ) & 0xFF];
+    return true;
+}
+
+uint32_t rb_crc_value( const Rb_Crc_t* p_crc )
+{
+    return p_crc->state ^ crc_final_xor[p_crc->kind];
+}
+
+/* One-shot CRCs */
+static uint32_t crc_range( Rb_Crc_Kind_t kind, const Ring_Buffer_Byte_t* p_buf, uint8_t index, uint8_t count )
+{
+    Rb_Crc_t crc;
+    rb_crc_initialize( &crc, kind );
+    rb_crc_update_B( &crc, p_buf, index, count );
+    return rb_crc_value( &crc );
+}
+
+uint16_t rb_crc16_B( const Ring_Buffer_Byte_t* p_buf, uint8_t index, uint8_t count )
+{
+    return (uint16_t)crc_range( RB_CRC16_MODBUS, p_buf, index, count );
+}
+
+uint32_t rb_crc32_B( const Ring_Buffer_Byte_t* p_buf, uint8_t index, uint8_t count )
+{
+    return crc_range( RB_CRC32, p_buf, index, count );
+}
+
+uint32_t rb_crc32c_B( const Ring_Buffer_Byte_t* p_buf, uint8_t index, uint8_t count )
+{
+    return crc_range( RB_CRC32C, p_buf, index, count );
+}
@@ -0,0 +1,91 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/* Ring_Buffer_CRC.h
+ *
+ * CRCs computed directly over a range of the active elements of a Ring_Buffer_Byte_t, so a received packet can be
+ * checked without copying it out of the ring first.
+ *
+ * Three standard reflected CRCs are provided:
+ *  - RB_CRC16_MODBUS  poly 0x8005, init 0xFFFF, no final xor     ("123456789" -> 0x4B37)
+ *  - RB_CRC32         poly 0x04C11DB7, init and xor 0xFFFFFFFF  ("123456789" -> 0xCBF43926)
+ *  - RB_CRC32C        poly 0x1EDC6F41, init and xor 0xFFFFFFFF  ("123456789" -> 0xE3069283)
+ *
+ * The range is processed as the (up to two) contiguous segments of the ring using slicing-by-8 tables, eight bytes
+ * per step. On x86-64 CPUs with SSE4.2 CRC-32C uses the crc32 instruction instead, chosen at run time. The tables are
+ * built on first use.
+ *
+ * An Rb_Crc_t carries a CRC across calls: it can be fed ring ranges, plain arrays, or updated byte by byte as
+ * rb_crc_push_back_B appends to a ring, so a packet's CRC is ready as soon as its last byte arrives. It refuses to
+ * push into a full ring rather than drop the oldest byte, which the CRC would still cover.
+ *
+ * Functions implemented are as follows:
+ *
+ * rb_crc16_B           <-- CRC-16/MODBUS of a range of active elements
+ * rb_crc32_B           <-- CRC-32 of a range of active elements
+ * rb_crc32c_B          <-- CRC-32C of a range of active elements
+ * rb_crc_initialize    <-- Starts an incremental CRC
+ * rb_crc_update        <-- Adds an array
+ * rb_crc_update_B      <-- Adds a range of active elements
+ * rb_crc_push_back_B   <-- Appends a byte to a ring and adds it, unless the ring is full
+ * rb_crc_value         <-- The CRC of everything added so far
+ *
+ * The tables take 24 kB, so this is not built for AVR_MCU.
+ * */
+#ifndef RING_BUFFER_CRC_H
+#define RING_BUFFER_CRC_H
+
+#include "Ring_Buffer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum { RB_CRC16_MODBUS, RB_CRC32, RB_CRC32C } Rb_Crc_Kind_t;
+
+// running CRC, the state is kept before the final xor
+typedef struct {
+    Rb_Crc_Kind_t kind;
+    uint32_t state;
+} Rb_Crc_t;
+
+/* One-shot CRCs of count active elements starting at index, clamped to the active length */
+uint16_t rb_crc16_B( const Ring_Buffer_Byte_t* p_buf, uint8_t index, uint8_t count );
+uint32_t rb_crc32_B( const Ring_Buffer_Byte_t* p_buf, uint8_t index, uint8_t count );
+uint32_t rb_crc32c_B( const Ring_Buffer_Byte_t* p_buf, uint8_t index, uint8_t count );
+
+/* Incremental CRCs */
+void rb_crc_initialize( Rb_Crc_t* p_crc, Rb_Crc_Kind_t kind );
+void rb_crc_update( Rb_Crc_t* p_crc, const uint8_t* p_data, size_t length );
+void rb_crc_update_B( Rb_Crc_t* p_crc, const Ring_Buffer_Byte_t* p_buf, uint8_t index, uint8_t count );
+bool rb_crc_push_back_B( Rb_Crc_t* p_crc, Ring_Buffer_Byte_t* p_buf, uint8_t value );
+uint32_t rb_crc_value( const Rb_Crc_t* p_crc );
+
+#endif
@@ -0,0 +1,156 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Ring_Buffer_Delta.h"
+
+#include <string.h>  // for memcpy
+
+// rounds to the nearest step, saturating at the int32_t range
+static int32_t delta_quantize( const Rb_Delta_t* p_delta, float value )
+{
+    float steps = value * p_delta->steps_per_unit;
+    if( steps >= 2147483520.0f )  // largest float below 2^31
+        return INT32_MAX;
+    if( steps <= -2147483648.0f )
+        return INT32_MIN;
+    return (int32_t)( steps + ( ( steps >= 0.0f ) ? 0.5f : -0.5f ) );
+}
+
+/* Initialization */
+void rb_delta_initialize( Rb_Delta_t* p_delta, float resolution )
+{
+    p_delta->resolution     = resolution;
+    p_delta->steps_per_unit = 1.0f / resolution;
+    p_delta->last           = 0;
+    p_delta->samples        = 0;
+    p_delta->bytes          = 0;
+    p_delta->corrupt        = false;
+}
+
+/* Conversion */
+uint16_t rb_delta_encode( Rb_Delta_t* p_delta, Ring_Buffer_Float_t* p_src, Ring_Buffer_Byte_t* p_dst )
+{
+    const float* p_samples;
+    uint8_t span;
+    uint16_t encoded = 0;
+
+    // source spans, at most two
+    while( ( span = rb_read_span_F( p_src, &p_samples ) ) > 0 ) {
+        uint8_t used = 0;
+        for( ; used < span; used++ ) {
+            int32_t value = delta_quantize( p_delta, p_samples[used] );
+            uint32_t diff = (uint32_t)value - (uint32_t)p_delta->last;
+            uint32_t zig  = ( diff << 1 ) ^ (uint32_t)( -(int32_t)( diff >> 31 ) );
+
+            uint8_t bytes[RB_DELTA_MAX_BYTES];
+            uint8_t count = 0;
+            while( zig >= 0x80 ) {
+                bytes[count++] = (uint8_t)( zig | 0x80 );
+                zig >>= 7;
+            }
+            bytes[count++] = (uint8_t)zig;
+
+            uint8_t* p_out;
+            uint8_t room = rb_write_span_B( p_dst, &p_out );
+            if( room >= count ) {
+                memcpy( p_out, bytes, count );
+                rb_commit_B( p_dst, count );
+            } else if( RB_LENGTH_B - 1 - rb_length_B( p_dst ) >= count ) {
+                // the varint straddles the wrap point
+                memcpy( p_out, bytes, room );
+                rb_commit_B( p_dst, room );
+                rb_write_span_B( p_dst, &p_out );
+                memcpy( p_out, bytes + room, count - room );
+                rb_commit_B( p_dst, count - room );
+            } else {
+                break;
+            }
+
+            p_delta->last = value;
+            p_delta->bytes += count;
+        }
+
+        rb_consume_F( p_src, used );
+        encoded += used;
+        if( used < span )
+            break;
+    }
+
+    p_delta->samples += encoded;
+    return encoded;
+}
+
+uint16_t rb_delta_decode( Rb_Delta_t* p_delta, Ring_Buffer_Byte_t* p_src, Ring_Buffer_Float_t* p_dst )
+{
+    const uint8_t* p_bytes;
+    uint8_t span     = rb_read_span_B( p_src, &p_bytes );
+    uint8_t length   = rb_length_B( p_src );
+    uint8_t position = 0;
+    uint16_t decoded = 0;
+
+    while( !p_delta->corrupt && rb_length_F( p_dst ) < RB_LENGTH_F - 1 ) {
+        // find the end of the next varint without consuming, it may not have fully arrived
+        uint32_t zig  = 0;
+        uint8_t count = 0;
+        uint8_t byte  = 0x80;
+        while( ( byte & 0x80 ) && count < RB_DELTA_MAX_BYTES && position + count < length ) {
+            // straight from the first span, only a varint past the wrap point goes through rb_get_B
+            byte = ( position + count < span ) ? p_bytes[position + count] : rb_get_B( p_src, position + count );
+            zig |= (uint32_t)( byte & 0x7F ) << ( 7 * count );
+            count++;
+        }
+        if( ( byte & 0x80 ) && count < RB_DELTA_MAX_BYTES )
+            break;
+
+        // the encoder never writes more than 32 bits, so a longer varint means the stream is damaged
+        if( count == RB_DELTA_MAX_BYTES && byte > 0x0F ) {
+            p_delta->corrupt = true;
+            break;
+        }
+
+        uint32_t diff = ( zig >> 1 ) ^ ( 0u - ( zig & 1 ) );
+        p_delta->last = (int32_t)( (uint32_t)p_delta->last + diff );
+        // in double so a running value above 2^24 steps is not rounded before it is scaled
+        rb_push_back_F( p_dst, (float)( (double)p_delta->last * p_delta->resolution ) );
+
+        position += count;
+        p_delta->bytes += count;
+        decoded++;
+    }
+
+    rb_consume_B( p_src, position );
+    p_delta->samples += decoded;
+    return decoded;
+}
+
+float rb_delta_ratio( const Rb_Delta_t* p_delta )
+{
+    return ( p_delta->bytes == 0 ) ? 0.0f : 4.0f * p_delta->samples / p_delta->bytes;
+}
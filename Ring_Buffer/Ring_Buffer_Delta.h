@@ -0,0 +1,86 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/* Ring_Buffer_Delta.h
+ *
+ * Compresses a stream of slowly changing floats from a Ring_Buffer_Float_t into a Ring_Buffer_Byte_t for a slow link,
+ * and expands it again on the far side.
+ *
+ * Each sample is quantized to an integer number of resolution steps, the difference to the previous quantized sample
+ * is zigzag mapped so small negative steps stay small, and the result is written as a varint of 7 bits per byte with
+ * the top bit set on every byte but the last. A sensor that moves a few steps per sample therefore costs one byte
+ * instead of four. Decoding reproduces each sample to within resolution / 2 while it stays within 2^24 steps of 0;
+ * further out a float is coarser than a step and the sample is also rounded to the nearest float. On AVR_MCU double
+ * is float, so there the decoded value is rounded once more.
+ *
+ * The encoder and decoder each keep the last quantized value, so both must start from rb_delta_initialize with the
+ * same resolution, and a byte lost on the link corrupts every following sample until both are re-initialized.
+ * Carry the stream in frames (COBS or SLIP) and re-initialize per frame if the link can drop bytes. A varint longer
+ * than 32 bits can only come from a damaged stream: the decoder leaves it in the byte ring, sets corrupt and decodes
+ * nothing more until it is re-initialized.
+ *
+ * Functions implemented are as follows:
+ *
+ * rb_delta_initialize  <-- Sets the resolution and resets the running value and statistics
+ * rb_delta_encode      <-- Moves as many samples as fit from a float ring into a byte ring
+ * rb_delta_decode      <-- Moves as many complete samples as fit from a byte ring into a float ring
+ * rb_delta_ratio       <-- Raw float bytes per encoded byte so far
+ * */
+#ifndef RING_BUFFER_DELTA_H
+#define RING_BUFFER_DELTA_H
+
+#include "Ring_Buffer.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RB_DELTA_MAX_BYTES 5  // a 32 bit varint
+
+typedef struct {
+    float resolution;
+    float steps_per_unit;  // 1 / resolution
+    int32_t last;          // previous quantized sample
+    uint32_t samples;      // samples encoded or decoded
+    uint32_t bytes;        // bytes produced or consumed
+    bool corrupt;          // the decoder met a varint longer than 32 bits
+} Rb_Delta_t;
+
+/* Initialization, resolution is the quantization step in the samples' units */
+void rb_delta_initialize( Rb_Delta_t* p_delta, float resolution );
+
+/* Conversion, returning the number of samples moved. Samples are only moved whole: encoding stops when the next
+   sample's bytes do not fit and decoding leaves an incomplete varint in the byte ring */
+uint16_t rb_delta_encode( Rb_Delta_t* p_delta, Ring_Buffer_Float_t* p_src, Ring_Buffer_Byte_t* p_dst );
+uint16_t rb_delta_decode( Rb_Delta_t* p_delta, Ring_Buffer_Byte_t* p_src, Ring_Buffer_Float_t* p_dst );
+
+/* Compression ratio, 4 * samples / bytes */
+float rb_delta_ratio( const Rb_Delta_t* p_delta );
+
+#endif
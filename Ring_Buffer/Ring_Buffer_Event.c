@@ -0,0 +1,133 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Ring_Buffer_Event.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+static uint32_t event_length( const Rb_Event_t* p_event )
+{
+    return ( p_event->p_byte != NULL ) ? rb_spsc_length_B( p_event->p_byte ) : rb_spsc_length_F( p_event->p_float );
+}
+
+static int event_initialize( Rb_Event_t* p_event, uint32_t threshold )
+{
+    // a full ring holds RB_LENGTH_SPSC elements, so a larger threshold would never be reached
+    if( threshold > RB_LENGTH_SPSC )
+        threshold = RB_LENGTH_SPSC;
+
+    p_event->threshold = ( threshold == 0 ) ? 1 : threshold;
+    atomic_init( &p_event->signals, 0 );
+    atomic_init( &p_event->armed, true );
+
+    p_event->fd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    return p_event->fd;
+}
+
+// signals the descriptor once per arming, whichever of producer or consumer gets there first
+static void event_signal_if_ready( Rb_Event_t* p_event )
+{
+    if( event_length( p_event ) < p_event->threshold )
+        return;
+
+    bool expected = true;
+    if( !atomic_compare_exchange_strong( &p_event->armed, &expected, false ) )
+        return;
+
+    uint64_t one = 1;
+    if( write( p_event->fd, &one, sizeof( one ) ) == sizeof( one ) )
+        atomic_fetch_add_explicit( &p_event->signals, 1, memory_order_relaxed );
+}
+
+/* Initialization */
+int rb_event_initialize_B( Rb_Event_t* p_event, Ring_Buffer_SPSC_Byte_t* p_buf, uint32_t threshold )
+{
+    p_event->p_byte  = p_buf;
+    p_event->p_float = NULL;
+    return event_initialize( p_event, threshold );
+}
+
+int rb_event_initialize_F( Rb_Event_t* p_event, Ring_Buffer_SPSC_Float_t* p_buf, uint32_t threshold )
+{
+    p_event->p_byte  = NULL;
+    p_event->p_float = p_buf;
+    return event_initialize( p_event, threshold );
+}
+
+void rb_event_close( Rb_Event_t* p_event )
+{
+    if( p_event->fd >= 0 )
+        close( p_event->fd );
+    p_event->fd = -1;
+}
+
+/* Producer */
+void rb_event_notify( Rb_Event_t* p_event )
+{
+    // cheap check first so pushes below the threshold or while already signalled stay out of the kernel
+    if( !atomic_load_explicit( &p_event->armed, memory_order_relaxed ) )
+        return;
+
+    atomic_thread_fence( memory_order_seq_cst );
+    event_signal_if_ready( p_event );
+}
+
+bool rb_event_push_back_B( Rb_Event_t* p_event, uint8_t value )
+{
+    if( !rb_spsc_push_back_B( p_event->p_byte, value ) )
+        return false;
+
+    rb_event_notify( p_event );
+    return true;
+}
+
+bool rb_event_push_back_F( Rb_Event_t* p_event, float value )
+{
+    if( !rb_spsc_push_back_F( p_event->p_float, value ) )
+        return false;
+
+    rb_event_notify( p_event );
+    return true;
+}
+
+/* Consumer */
+uint32_t rb_event_ack( Rb_Event_t* p_event )
+{
+    // EAGAIN only means the descriptor was already clear
+    uint64_t count;
+    (void)!read( p_event->fd, &count, sizeof( count ) );
+
+    atomic_store( &p_event->armed, true );
+
+    // a push between the drain and the re-arm saw armed == false and did not signal, so check on its behalf
+    event_signal_if_ready( p_event );
+    return event_length( p_event );
+}
@@ -0,0 +1,103 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/* Ring_Buffer_Event.h
+ *
+ * Attaches an eventfd to a Ring_Buffer_SPSC_Byte_t or Ring_Buffer_SPSC_Float_t so its consumer can sit in an
+ * epoll/poll/select loop next to sockets and timers instead of needing a polling thread.
+ *
+ * The descriptor becomes readable once the ring holds at least threshold elements. The producer pushes through
+ * rb_event_push_back_X, or pushes by any other means and then calls rb_event_notify; only the push that crosses the
+ * threshold writes to the eventfd, so a burst costs one system call. After the loop reports the descriptor readable
+ * the consumer drains what it wants and calls rb_event_ack, which clears the descriptor and re-arms it. If the ring is
+ * still at or above the threshold after the ack the descriptor is signalled again straight away, so level-triggered
+ * loops never lose data.
+ *
+ * Example:
+ *
+ *     int fd = rb_event_initialize_B( &event, &ring, 32 );
+ *     struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &event };
+ *     epoll_ctl( epfd, EPOLL_CTL_ADD, fd, &ev );
+ *     ...
+ *     while( epoll_wait( epfd, &ev, 1, -1 ) > 0 ) {
+ *         if( ev.data.ptr == &event ) {
+ *             uint8_t value;
+ *             while( rb_spsc_pop_front_B( &ring, &value ) )
+ *                 handle( value );
+ *             rb_event_ack( &event );
+ *         }
+ *     }
+ *
+ * One producer thread and one consumer thread per ring. The SPSC ring's acquire/release counters order the data
+ * against the length the consumer sees, and a push into a full ring fails rather than overwriting. A threshold above
+ * RB_LENGTH_SPSC is clamped to RB_LENGTH_SPSC.
+ *
+ * Functions implemented are as follows:
+ *
+ * rb_event_initialize_B/F  <-- Attaches a new eventfd to a ring, returns the descriptor
+ * rb_event_push_back_B/F   <-- Producer: appends an element and signals if the threshold is reached, false if full
+ * rb_event_notify          <-- Producer: signals if the threshold is reached
+ * rb_event_ack             <-- Consumer: clears the descriptor and re-arms it
+ * rb_event_close           <-- Closes the descriptor
+ *
+ * Linux only; not built for AVR_MCU.
+ * */
+#ifndef RING_BUFFER_EVENT_H
+#define RING_BUFFER_EVENT_H
+
+#include "Ring_Buffer_SPSC.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    Ring_Buffer_SPSC_Byte_t* p_byte;
+    Ring_Buffer_SPSC_Float_t* p_float;
+    int fd;
+    uint32_t threshold;
+    atomic_bool armed;         // true until the producer signals, set again by rb_event_ack
+    _Atomic uint64_t signals;  // eventfd writes from either side, for comparing against the number of pushes
+} Rb_Event_t;
+
+/* Initialization, returns the eventfd or -1 if it could not be created */
+int rb_event_initialize_B( Rb_Event_t* p_event, Ring_Buffer_SPSC_Byte_t* p_buf, uint32_t threshold );
+int rb_event_initialize_F( Rb_Event_t* p_event, Ring_Buffer_SPSC_Float_t* p_buf, uint32_t threshold );
+void rb_event_close( Rb_Event_t* p_event );
+
+/* Producer */
+bool rb_event_push_back_B( Rb_Event_t* p_event, uint8_t value );
+bool rb_event_push_back_F( Rb_Event_t* p_event, float value );
+void rb_event_notify( Rb_Event_t* p_event );
+
+/* Consumer, returns the number of elements left in the ring */
+uint32_t rb_event_ack( Rb_Event_t* p_event );
+
+#endif
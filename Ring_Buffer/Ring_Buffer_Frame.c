@@ -0,0 +1,237 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Ring_Buffer_Frame.h"
+
+#include <string.h>  // for memchr, memcpy and memmove
+
+#define SLIP_END     0xC0
+#define SLIP_ESC     0xDB
+#define SLIP_ESC_END 0xDC
+#define SLIP_ESC_ESC 0xDD
+
+// appends bytes through the write spans, the caller has checked there is room
+static void frame_put( Ring_Buffer_Byte_t* p_buf, const uint8_t* p_data, uint8_t count )
+{
+    while( count > 0 ) {
+        uint8_t* p_dst;
+        uint8_t span = rb_write_span_B( p_buf, &p_dst );
+        if( span > count )
+            span = count;
+
+        memcpy( p_dst, p_data, span );
+        rb_commit_B( p_buf, span );
+        p_data += span;
+        count -= span;
+    }
+}
+
+static void frame_put_byte( Ring_Buffer_Byte_t* p_buf, uint8_t value )
+{
+    frame_put( p_buf, &value, 1 );
+}
+
+static uint8_t frame_count( const uint8_t* p_data, uint8_t length, uint8_t value )
+{
+    uint8_t count           = 0;
+    const uint8_t* p_limit  = p_data + length;
+    const uint8_t* p_search = p_data;
+
+    while( ( p_search = memchr( p_search, value, p_limit - p_search ) ) != NULL ) {
+        count++;
+        p_search++;
+    }
+    return count;
+}
+
+// copies the first count bytes of the ring out with at most two memcpy calls, without removing them
+static void frame_copy( const Ring_Buffer_Byte_t* p_buf, uint8_t* p_out, uint8_t count )
+{
+    const uint8_t* p_first;
+    uint8_t first = rb_read_span_B( p_buf, &p_first );
+    if( first > count )
+        first = count;
+
+    memcpy( p_out, p_first, first );
+    memcpy( p_out + first, p_buf->buffer, count - first );
+}
+
+// copies the next frame ending in delimiter to p_out and removes it with its delimiter, skipping empty frames
+static int16_t frame_take( Ring_Buffer_Byte_t* p_buf, uint8_t delimiter, uint8_t* p_out, uint8_t capacity )
+{
+    int16_t end;
+    while( ( end = rb_find_B( p_buf, delimiter ) ) == 0 )
+        rb_consume_B( p_buf, 1 );
+
+    if( end < 0 ) {
+        // a full ring that still has no delimiter can never complete, drop it to resynchronize
+        if( rb_length_B( p_buf ) == RB_LENGTH_B - 1 ) {
+            rb_consume_B( p_buf, RB_LENGTH_B - 1 );
+            return RB_FRAME_INVALID;
+        }
+        return RB_FRAME_INCOMPLETE;
+    }
+
+    if( end > capacity ) {
+        rb_consume_B( p_buf, end + 1 );
+        return RB_FRAME_INVALID;
+    }
+
+    frame_copy( p_buf, p_out, end );
+    rb_consume_B( p_buf, end + 1 );
+    return end;
+}
+
+/* COBS */
+uint8_t rb_cobs_encode_B( Ring_Buffer_Byte_t* p_buf, const uint8_t* p_data, uint8_t length )
+{
+    // one code byte per run of at most 254 non-zero bytes, plus the delimiter
+    uint16_t size = length + length / 254 + 2;
+    if( size > RB_LENGTH_B - 1 - rb_length_B( p_buf ) )
+        return 0;
+
+    uint8_t start = rb_length_B( p_buf );
+    uint8_t pos   = 0;
+
+    for( ;; ) {
+        uint8_t max_run       = ( length - pos < 254 ) ? length - pos : 254;
+        const uint8_t* p_zero = memchr( p_data + pos, 0, max_run );
+        uint8_t run           = ( p_zero != NULL ) ? (uint8_t)( p_zero - ( p_data + pos ) ) : max_run;
+
+        frame_put_byte( p_buf, run + 1 );
+        frame_put( p_buf, p_data + pos, run );
+        pos += run;
+
+        // a zero is implied by the code, so skip it and always follow it with another code, even at the end
+        if( p_zero != NULL ) {
+            pos++;
+            continue;
+        }
+        if( run == 254 && pos < length )
+            continue;
+        break;
+    }
+
+    frame_put_byte( p_buf, 0 );
+    return rb_length_B( p_buf ) - start;
+}
+
+int16_t rb_cobs_decode_B( Ring_Buffer_Byte_t* p_buf, uint8_t* p_out, uint8_t capacity )
+{
+    int16_t length = frame_take( p_buf, 0, p_out, capacity );
+    if( length < 0 )
+        return length;
+
+    // decoding never writes ahead of where it reads, so it works in place
+    uint8_t in = 0, out = 0;
+    while( in < length ) {
+        uint8_t code = p_out[in++];
+        if( code - 1 > length - in )
+            return RB_FRAME_INVALID;
+
+        memmove( p_out + out, p_out + in, code - 1 );
+        out += code - 1;
+        in += code - 1;
+        if( code != 0xFF && in < length )
+            p_out[out++] = 0;
+    }
+    return out;
+}
+
+/* SLIP */
+uint8_t rb_slip_encode_B( Ring_Buffer_Byte_t* p_buf, const uint8_t* p_data, uint8_t length )
+{
+    // the decoder skips empty frames, so there is nothing worth sending
+    if( length == 0 )
+        return 0;
+
+    // two END bytes plus one extra byte per escaped END or ESC
+    uint16_t size = length + frame_count( p_data, length, SLIP_END ) + frame_count( p_data, length, SLIP_ESC ) + 2;
+    if( size > RB_LENGTH_B - 1 - rb_length_B( p_buf ) )
+        return 0;
+
+    const uint8_t* p          = p_data;
+    const uint8_t* p_limit    = p_data + length;
+    const uint8_t* p_end_byte = memchr( p_data, SLIP_END, length );
+    const uint8_t* p_esc_byte = memchr( p_data, SLIP_ESC, length );
+    frame_put_byte( p_buf, SLIP_END );
+
+    // copy the runs between special bytes whole, tracking the next END and ESC with memchr
+    while( p < p_limit ) {
+        const uint8_t* p_special = p_limit;
+        if( p_end_byte != NULL && p_end_byte < p_special )
+            p_special = p_end_byte;
+        if( p_esc_byte != NULL && p_esc_byte < p_special )
+            p_special = p_esc_byte;
+
+        frame_put( p_buf, p, (uint8_t)( p_special - p ) );
+        if( p_special == p_limit )
+            break;
+
+        uint8_t escaped[2] = { SLIP_ESC, ( *p_special == SLIP_END ) ? SLIP_ESC_END : SLIP_ESC_ESC };
+        frame_put( p_buf, escaped, 2 );
+        p = p_special + 1;
+
+        if( p_special == p_end_byte )
+            p_end_byte = memchr( p, SLIP_END, p_limit - p );
+        else
+            p_esc_byte = memchr( p, SLIP_ESC, p_limit - p );
+    }
+
+    frame_put_byte( p_buf, SLIP_END );
+    return (uint8_t)size;
+}
+
+int16_t rb_slip_decode_B( Ring_Buffer_Byte_t* p_buf, uint8_t* p_out, uint8_t capacity )
+{
+    int16_t length = frame_take( p_buf, SLIP_END, p_out, capacity );
+    if( length < 0 )
+        return length;
+
+    // unescaping only shrinks the frame, so move the runs between escapes down in place
+    uint8_t* p_read  = p_out;
+    uint8_t* p_write = p_out;
+    uint8_t* p_limit = p_out + length;
+    while( p_read < p_limit ) {
+        uint8_t* p_esc = memchr( p_read, SLIP_ESC, p_limit - p_read );
+        uint8_t* p_run = ( p_esc != NULL ) ? p_esc : p_limit;
+
+        memmove( p_write, p_read, p_run - p_read );
+        p_write += p_run - p_read;
+        if( p_esc == NULL )
+            break;
+
+        if( p_esc + 1 == p_limit || ( p_esc[1] != SLIP_ESC_END && p_esc[1] != SLIP_ESC_ESC ) )
+            return RB_FRAME_INVALID;
+        *p_write++ = ( p_esc[1] == SLIP_ESC_END ) ? SLIP_END : SLIP_ESC;
+        p_read     = p_esc + 2;
+    }
+    return (int16_t)( p_write - p_out );
+}
@@ -0,0 +1,72 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/* Ring_Buffer_Frame.h
+ *
+ * Packet framing over a Ring_Buffer_Byte_t with COBS or SLIP, for serial links.
+ *
+ * Encoding writes one complete frame into the ring or nothing, so a frame is never half queued. Decoding finds the
+ * delimiter with rb_find_B, copies the frame out with at most two memcpy calls and removes the escaping in place in
+ * the caller's buffer, again by memchr/memmove over runs rather than byte by byte. Bytes stay in the ring until a
+ * whole frame has arrived.
+ *
+ * COBS frames end with a 0x00 delimiter and contain no other zero. SLIP frames start and end with 0xC0 (END) and
+ * escape END and 0xDB (ESC) as ESC 0xDC and ESC 0xDD. Empty frames, such as the END that starts every SLIP frame,
+ * are skipped, so rb_slip_encode_B appends nothing for empty data and returns 0; COBS encodes empty data as the code
+ * byte 0x01, which decodes to a frame of length 0. A frame too long for the caller's buffer, or a full ring without a delimiter, is dropped and reported
+ * as RB_FRAME_INVALID so the stream resynchronizes on the next delimiter.
+ *
+ * Functions implemented are as follows:
+ *
+ * rb_cobs_encode_B  <-- Appends a COBS frame for the given data
+ * rb_cobs_decode_B  <-- Removes the next COBS frame and decodes it
+ * rb_slip_encode_B  <-- Appends a SLIP frame for the given data
+ * rb_slip_decode_B  <-- Removes the next SLIP frame and decodes it
+ * */
+#ifndef RING_BUFFER_FRAME_H
+#define RING_BUFFER_FRAME_H
+
+#include "Ring_Buffer.h"
+
+#include <stdint.h>
+
+#define RB_FRAME_INCOMPLETE -1  // no complete frame in the ring yet, nothing was removed
+#define RB_FRAME_INVALID    -2  // a frame was removed but could not be decoded
+
+/* Encoding, returns the number of bytes appended or 0 if the frame does not fit in the free space (or is an empty
+   SLIP frame) */
+uint8_t rb_cobs_encode_B( Ring_Buffer_Byte_t* p_buf, const uint8_t* p_data, uint8_t length );
+uint8_t rb_slip_encode_B( Ring_Buffer_Byte_t* p_buf, const uint8_t* p_data, uint8_t length );
+
+/* Decoding, returns the frame length written to p_out, RB_FRAME_INCOMPLETE or RB_FRAME_INVALID */
+int16_t rb_cobs_decode_B( Ring_Buffer_Byte_t* p_buf, uint8_t* p_out, uint8_t capacity );
+int16_t rb_slip_decode_B( Ring_Buffer_Byte_t* p_buf, uint8_t* p_out, uint8_t capacity );
+
+#endif
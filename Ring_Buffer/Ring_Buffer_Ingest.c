@@ -0,0 +1,344 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Ring_Buffer_Ingest.h"
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define RB_INGEST_QUEUE_DEPTH 128  // power of 2, at least RB_INGEST_MAX_SOURCES
+
+_Static_assert( RB_INGEST_QUEUE_DEPTH >= RB_INGEST_MAX_SOURCES, "every source needs room for its outstanding read" );
+
+// io_uring user_data: the source index, with this bit set for a readiness poll rather than a read
+#define RB_INGEST_POLL_FLAG ( (uint64_t)1 << 32 )
+
+// the free space of a ring as up to two segments, returns the segment count
+static int ingest_free_segments( Ring_Buffer_Byte_t* p_buf, struct iovec* p_segments )
+{
+    uint8_t* p_data;
+    uint8_t first = rb_write_span_B( p_buf, &p_data );
+    if( first == 0 )
+        return 0;
+
+    p_segments[0].iov_base = p_data;
+    p_segments[0].iov_len  = first;
+
+    // whatever the first span left is at the start of storage
+    uint8_t remaining = RB_LENGTH_B - 1 - rb_length_B( p_buf ) - first;
+    if( remaining == 0 )
+        return 1;
+
+    p_segments[1].iov_base = p_buf->buffer;
+    p_segments[1].iov_len  = remaining;
+    return 2;
+}
+
+/* io_uring backend */
+static bool uring_setup( Rb_Ingest_t* p_ingest )
+{
+    struct io_uring_params params;
+    memset( &params, 0, sizeof( params ) );
+
+    int fd = (int)syscall( __NR_io_uring_setup, RB_INGEST_QUEUE_DEPTH, &params );
+    if( fd < 0 )
+        return false;
+    if( !( params.features & IORING_FEAT_EXT_ARG ) ) {
+        close( fd );
+        return false;
+    }
+
+    p_ingest->ring_fd     = fd;
+    p_ingest->sq_map_size = params.sq_off.array + params.sq_entries * sizeof( uint32_t );
+    p_ingest->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof( struct io_uring_cqe );
+    p_ingest->sqes_size   = params.sq_entries * sizeof( struct io_uring_sqe );
+
+    // newer kernels map both rings with one mmap
+    if( params.features & IORING_FEAT_SINGLE_MMAP ) {
+        if( p_ingest->cq_map_size > p_ingest->sq_map_size )
+            p_ingest->sq_map_size = p_ingest->cq_map_size;
+        p_ingest->cq_map_size = 0;
+    }
+
+    p_ingest->p_sq_map = mmap( NULL, p_ingest->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING );
+    p_ingest->p_cq_map = p_ingest->p_sq_map;
+    if( p_ingest->p_sq_map != MAP_FAILED && p_ingest->cq_map_size != 0 )
+        p_ingest->p_cq_map = mmap( NULL, p_ingest->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING );
+    p_ingest->p_sqes = mmap( NULL, p_ingest->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES );
+
+    if( p_ingest->p_sq_map == MAP_FAILED || p_ingest->p_cq_map == MAP_FAILED || p_ingest->p_sqes == MAP_FAILED ) {
+        if( p_ingest->p_sq_map != MAP_FAILED )
+            munmap( p_ingest->p_sq_map, p_ingest->sq_map_size );
+        if( p_ingest->cq_map_size != 0 && p_ingest->p_cq_map != MAP_FAILED )
+            munmap( p_ingest->p_cq_map, p_ingest->cq_map_size );
+        if( p_ingest->p_sqes != MAP_FAILED )
+            munmap( p_ingest->p_sqes, p_ingest->sqes_size );
+        close( fd );
+        return false;
+    }
+
+    uint8_t* p_sq           = p_ingest->p_sq_map;
+    uint8_t* p_cq           = p_ingest->p_cq_map;
+    p_ingest->p_sq_tail     = (uint32_t*)( p_sq + params.sq_off.tail );
+    p_ingest->p_sq_mask     = (uint32_t*)( p_sq + params.sq_off.ring_mask );
+    p_ingest->p_sq_array    = (uint32_t*)( p_sq + params.sq_off.array );
+    p_ingest->sq_entries    = params.sq_entries;
+    p_ingest->p_cq_head     = (uint32_t*)( p_cq + params.cq_off.head );
+    p_ingest->p_cq_tail     = (uint32_t*)( p_cq + params.cq_off.tail );
+    p_ingest->p_cq_mask     = (uint32_t*)( p_cq + params.cq_off.ring_mask );
+    p_ingest->p_cqes        = (struct io_uring_cqe*)( p_cq + params.cq_off.cqes );
+    return true;
+}
+
+// queues a readv into the ring's free space for every idle source, or a readiness poll for a nonblocking source whose
+// last read found nothing, returns the number queued
+static uint32_t uring_queue_reads( Rb_Ingest_t* p_ingest )
+{
+    uint32_t tail   = *p_ingest->p_sq_tail;  // only this thread writes the tail
+    uint32_t queued = 0;
+
+    for( uint8_t i = 0; i < p_ingest->source_count; i++ ) {
+        Rb_Ingest_Source_t* p_source = &p_ingest->sources[i];
+        if( p_source->in_flight || p_source->closed )
+            continue;
+
+        int segment_count = ingest_free_segments( p_source->p_buf, p_source->segments );
+        if( segment_count == 0 )
+            continue;
+
+        uint32_t index            = ( tail + queued ) & *p_ingest->p_sq_mask;
+        struct io_uring_sqe* p_sq = &p_ingest->p_sqes[index];
+        memset( p_sq, 0, sizeof( *p_sq ) );
+        p_sq->fd = p_source->fd;
+        if( p_source->wait_ready ) {
+            // a readv on an O_NONBLOCK fd completes at once with -EAGAIN, so wait in the kernel for data instead
+            p_sq->opcode      = IORING_OP_POLL_ADD;
+            p_sq->poll_events = POLLIN;
+            p_sq->user_data   = i | RB_INGEST_POLL_FLAG;
+        } else {
+            p_sq->opcode    = IORING_OP_READV;
+            p_sq->addr      = (uint64_t)(uintptr_t)p_source->segments;
+            p_sq->len       = segment_count;
+            p_sq->off       = (uint64_t)-1;  // current file position, so pipes and ttys work
+            p_sq->user_data = i;
+        }
+
+        p_ingest->p_sq_array[index] = index;
+        p_source->in_flight         = true;
+        queued++;
+    }
+
+    atomic_store_explicit( (_Atomic uint32_t*)p_ingest->p_sq_tail, tail + queued, memory_order_release );
+    return queued;
+}
+
+static int uring_harvest( Rb_Ingest_t* p_ingest )
+{
+    uint32_t head = *p_ingest->p_cq_head;
+    uint32_t tail = atomic_load_explicit( (_Atomic uint32_t*)p_ingest->p_cq_tail, memory_order_acquire );
+    int moved     = 0;
+
+    for( ; head != tail; head++ ) {
+        struct io_uring_cqe* p_cq    = &p_ingest->p_cqes[head & *p_ingest->p_cq_mask];
+        Rb_Ingest_Source_t* p_source = &p_ingest->sources[(uint32_t)p_cq->user_data];
+
+        p_source->in_flight = false;
+        if( p_cq->user_data & RB_INGEST_POLL_FLAG ) {
+            // ready, hung up or in error: the next read finds out which. An interrupted poll is simply queued again.
+            if( p_cq->res >= 0 ) {
+                p_source->wait_ready = false;
+            } else if( p_cq->res != -EINTR ) {
+                p_source->closed = true;
+                p_source->error  = -p_cq->res;
+            }
+        } else if( p_cq->res > 0 ) {
+            // the data is already in the storage, publishing it is just moving the end index
+            p_source->p_buf->end_index = ( p_source->p_buf->end_index + p_cq->res ) & ( RB_LENGTH_B - 1 );
+            p_source->bytes += p_cq->res;
+            p_ingest->completions++;
+            moved += p_cq->res;
+        } else if( p_cq->res == -EAGAIN ) {
+            p_source->wait_ready = true;
+        } else if( p_cq->res != -EINTR ) {
+            p_source->closed = true;
+            p_source->error  = -p_cq->res;
+        }
+    }
+
+    atomic_store_explicit( (_Atomic uint32_t*)p_ingest->p_cq_head, head, memory_order_release );
+    return moved;
+}
+
+static int uring_poll( Rb_Ingest_t* p_ingest, int timeout_ms )
+{
+    // collect anything that finished since the last poll first, so those sources get their next read this round
+    int moved       = uring_harvest( p_ingest );
+    uint32_t queued = uring_queue_reads( p_ingest );
+
+    bool outstanding = false;
+    for( uint8_t i = 0; i < p_ingest->source_count; i++ )
+        outstanding |= p_ingest->sources[i].in_flight;
+
+    // wait only if nothing has arrived yet
+    uint32_t wait_for = ( moved > 0 || !outstanding ) ? 0 : 1;
+    if( queued == 0 && wait_for == 0 )
+        return moved;
+
+    struct __kernel_timespec timeout         = { timeout_ms / 1000, ( timeout_ms % 1000 ) * 1000000LL };
+    struct io_uring_getevents_arg wait_until = { 0 };
+    wait_until.ts                            = ( timeout_ms >= 0 ) ? (uint64_t)(uintptr_t)&timeout : 0;
+
+    // one system call submits the new reads and waits for the first completion
+    long entered = syscall( __NR_io_uring_enter, p_ingest->ring_fd, queued, wait_for, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &wait_until,
+                            sizeof( wait_until ) );
+    if( entered < 0 && errno != ETIME && errno != EINTR )
+        return -1;
+    if( wait_for != 0 )
+        p_ingest->waits++;
+
+    return moved + uring_harvest( p_ingest );
+}
+
+/* epoll backend */
+static int epoll_poll( Rb_Ingest_t* p_ingest, int timeout_ms )
+{
+    struct epoll_event events[RB_INGEST_MAX_SOURCES];
+    int watched = 0;
+
+    // only watch open sources with somewhere to put the data. Removing the rest from the set, rather than clearing
+    // their event mask, matters because EPOLLHUP and EPOLLERR are reported regardless of the mask.
+    for( uint8_t i = 0; i < p_ingest->source_count; i++ ) {
+        Rb_Ingest_Source_t* p_source = &p_ingest->sources[i];
+        bool want                    = !p_source->closed && rb_length_B( p_source->p_buf ) < RB_LENGTH_B - 1;
+        if( want != p_source->in_flight ) {
+            struct epoll_event ev = { .events = EPOLLIN, .data.u32 = i };
+            epoll_ctl( p_ingest->epoll_fd, want ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, p_source->fd, &ev );
+            p_source->in_flight = want;
+        }
+        watched += want;
+    }
+    if( watched == 0 )
+        return 0;
+
+    int ready = epoll_wait( p_ingest->epoll_fd, events, RB_INGEST_MAX_SOURCES, timeout_ms );
+    if( ready < 0 )
+        return ( errno == EINTR ) ? 0 : -1;
+    p_ingest->waits++;
+
+    int moved = 0;
+    for( int e = 0; e < ready; e++ ) {
+        Rb_Ingest_Source_t* p_source = &p_ingest->sources[events[e].data.u32];
+        if( rb_length_B( p_source->p_buf ) == RB_LENGTH_B - 1 )
+            continue;
+
+        // rb_read_fd_B only returns 0 for a read() that hit end of file
+        int got = rb_read_fd_B( p_source->p_buf, p_source->fd );
+        if( got > 0 ) {
+            p_source->bytes += got;
+            p_ingest->completions++;
+            moved += got;
+        } else if( got == 0 || ( errno != EAGAIN && errno != EINTR ) ) {
+            p_source->closed = true;
+            p_source->error  = ( got == 0 ) ? 0 : errno;
+        }
+    }
+
+    return moved;
+}
+
+/* Initialization */
+bool rb_ingest_initialize( Rb_Ingest_t* p_ingest, bool allow_uring )
+{
+    memset( p_ingest, 0, sizeof( *p_ingest ) );
+    p_ingest->ring_fd  = -1;
+    p_ingest->epoll_fd = -1;
+
+    if( allow_uring && uring_setup( p_ingest ) ) {
+        p_ingest->backend = RB_INGEST_URING;
+        return true;
+    }
+
+    p_ingest->backend  = RB_INGEST_EPOLL;
+    p_ingest->epoll_fd = epoll_create1( EPOLL_CLOEXEC );
+    return p_ingest->epoll_fd >= 0;
+}
+
+void rb_ingest_close( Rb_Ingest_t* p_ingest )
+{
+    if( p_ingest->backend == RB_INGEST_URING && p_ingest->ring_fd >= 0 ) {
+        // closing the ring cancels outstanding reads
+        munmap( p_ingest->p_sqes, p_ingest->sqes_size );
+        if( p_ingest->cq_map_size != 0 )
+            munmap( p_ingest->p_cq_map, p_ingest->cq_map_size );
+        munmap( p_ingest->p_sq_map, p_ingest->sq_map_size );
+        close( p_ingest->ring_fd );
+    }
+    if( p_ingest->epoll_fd >= 0 )
+        close( p_ingest->epoll_fd );
+
+    p_ingest->ring_fd  = -1;
+    p_ingest->epoll_fd = -1;
+}
+
+int rb_ingest_add( Rb_Ingest_t* p_ingest, int fd, Ring_Buffer_Byte_t* p_buf )
+{
+    if( p_ingest->source_count == RB_INGEST_MAX_SOURCES )
+        return -1;
+
+    uint8_t index                = p_ingest->source_count;
+    Rb_Ingest_Source_t* p_source = &p_ingest->sources[index];
+    memset( p_source, 0, sizeof( *p_source ) );
+    p_source->fd    = fd;
+    p_source->p_buf = p_buf;
+
+    if( p_ingest->backend == RB_INGEST_EPOLL ) {
+        struct epoll_event ev = { .events = EPOLLIN, .data.u32 = index };
+        if( epoll_ctl( p_ingest->epoll_fd, EPOLL_CTL_ADD, fd, &ev ) != 0 )
+            return -1;
+        p_source->in_flight = true;
+    }
+
+    p_ingest->source_count++;
+    return index;
+}
+
+int rb_ingest_poll( Rb_Ingest_t* p_ingest, int timeout_ms )
+{
+    if( p_ingest->backend == RB_INGEST_URING )
+        return uring_poll( p_ingest, timeout_ms );
+    return epoll_poll( p_ingest, timeout_ms );
+}
@@ -0,0 +1,117 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/* Ring_Buffer_Ingest.h
+ *
+ * Reads many file descriptors (serial ports, ptys, pipes, sockets) into their own Ring_Buffer_Byte_t from one thread.
+ *
+ * With io_uring, every source with free space keeps one readv outstanding. The readv targets the free segments of the
+ * ring itself, so the kernel lands the data directly in the ring storage, and each rb_ingest_poll submits the new
+ * reads and harvests every completion in a single io_uring_enter. If io_uring_setup fails, or the kernel lacks
+ * IORING_FEAT_EXT_ARG (5.11) for waiting with a timeout, the engine uses epoll and rb_read_fd_B instead. Sources whose
+ * ring is full, and sources that have closed, are removed from the epoll set until there is space again.
+ *
+ * The thread that calls rb_ingest_poll owns the rings: it may pop from them between polls but must not push, since a
+ * read may be outstanding on the free space. Nonblocking descriptors work with both backends: when an io_uring read
+ * of one completes with EAGAIN, the source's next submission is an IORING_OP_POLL_ADD, so rb_ingest_poll still
+ * sleeps up to its timeout instead of spinning. A source is marked closed with error 0 only when a read returns 0.
+ *
+ * Functions implemented are as follows:
+ *
+ * rb_ingest_initialize  <-- Sets up io_uring, or epoll if io_uring is unavailable or not wanted
+ * rb_ingest_add         <-- Adds a descriptor and the ring its data goes to
+ * rb_ingest_poll        <-- Starts reads, waits up to a timeout and moves completed data into the rings
+ * rb_ingest_close       <-- Releases the io_uring or epoll instance, the sources' descriptors stay open
+ *
+ * Linux only; not built for AVR_MCU.
+ * */
+#ifndef RING_BUFFER_INGEST_H
+#define RING_BUFFER_INGEST_H
+
+#include "Ring_Buffer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#ifndef RB_INGEST_MAX_SOURCES
+#    define RB_INGEST_MAX_SOURCES 64
+#endif
+
+typedef enum { RB_INGEST_URING, RB_INGEST_EPOLL } Rb_Ingest_Backend_t;
+
+typedef struct {
+    int fd;
+    Ring_Buffer_Byte_t* p_buf;
+    struct iovec segments[2];  // free space targeted by the outstanding io_uring read
+    bool in_flight;            // io_uring: a read or poll is outstanding. epoll: the fd is in the epoll set
+    bool wait_ready;           // io_uring: the last read found no data, poll for readiness before reading again
+    bool closed;               // end of file or a read error, no further reads are started
+    int error;                 // errno of the read error, 0 for end of file
+    uint64_t bytes;
+} Rb_Ingest_Source_t;
+
+typedef struct {
+    Rb_Ingest_Backend_t backend;
+    Rb_Ingest_Source_t sources[RB_INGEST_MAX_SOURCES];
+    uint8_t source_count;
+
+    // io_uring rings, mapped from the kernel
+    int ring_fd;
+    void* p_sq_map;
+    size_t sq_map_size;
+    void* p_cq_map;
+    size_t cq_map_size;
+    struct io_uring_sqe* p_sqes;
+    size_t sqes_size;
+    uint32_t *p_sq_tail, *p_sq_mask, *p_sq_array, sq_entries;
+    uint32_t *p_cq_head, *p_cq_tail, *p_cq_mask;
+    struct io_uring_cqe* p_cqes;
+
+    // epoll fallback
+    int epoll_fd;
+
+    uint64_t completions;  // reads that moved data
+    uint64_t waits;        // system calls that waited for completions or readiness
+} Rb_Ingest_t;
+
+/* Initialization, returns false if neither backend could be set up */
+bool rb_ingest_initialize( Rb_Ingest_t* p_ingest, bool allow_uring );
+void rb_ingest_close( Rb_Ingest_t* p_ingest );
+
+/* Adds a source, returns its index or -1 when RB_INGEST_MAX_SOURCES is reached or the fd cannot be watched */
+int rb_ingest_add( Rb_Ingest_t* p_ingest, int fd, Ring_Buffer_Byte_t* p_buf );
+
+/* Moves available data into the rings, waiting up to timeout_ms (negative waits forever) if there is none.
+   Returns the number of bytes moved, 0 on timeout or when no source can be read, -1 on error */
+int rb_ingest_poll( Rb_Ingest_t* p_ingest, int timeout_ms );
+
+#endif
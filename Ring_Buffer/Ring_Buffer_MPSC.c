@@ -0,0 +1,145 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Ring_Buffer_MPSC.h"
+
+static const uint32_t RB_MASK_MPSC = RB_LENGTH_MPSC - 1;
+
+/* Shared ring */
+void rb_mpsc_initialize_F( Ring_Buffer_MPSC_Float_t* p_buf )
+{
+    atomic_init( &p_buf->reserve_index, 0 );
+    atomic_init( &p_buf->start_index, 0 );
+
+    // position 0 is not written yet, so no slot may claim sequence 1
+    for( uint32_t i = 0; i < RB_LENGTH_MPSC; i++ )
+        atomic_init( &p_buf->slots[i].seq, 0 );
+}
+
+uint32_t rb_mpsc_length_F( Ring_Buffer_MPSC_Float_t* p_buf )
+{
+    return atomic_load( &p_buf->reserve_index ) - atomic_load( &p_buf->start_index );
+}
+
+uint32_t rb_mpsc_write_F( Ring_Buffer_MPSC_Float_t* p_buf, const float* p_data, uint32_t count )
+{
+    uint32_t reserve = atomic_load_explicit( &p_buf->reserve_index, memory_order_relaxed );
+    uint32_t granted;
+
+    // claim as much of the request as there is room for in one step
+    do {
+        uint32_t start = atomic_load_explicit( &p_buf->start_index, memory_order_acquire );
+        uint32_t space = RB_LENGTH_MPSC - ( reserve - start );
+        granted        = ( count < space ) ? count : space;
+        if( granted == 0 )
+            return 0;
+    } while( !atomic_compare_exchange_weak_explicit( &p_buf->reserve_index, &reserve, reserve + granted, memory_order_relaxed,
+                                                     memory_order_relaxed ) );
+
+    for( uint32_t i = 0; i < granted; i++ ) {
+        Rb_Mpsc_Slot_t* p_slot = &p_buf->slots[( reserve + i ) & RB_MASK_MPSC];
+        p_slot->value          = p_data[i];
+        atomic_store_explicit( &p_slot->seq, reserve + i + 1, memory_order_release );
+    }
+
+    return granted;
+}
+
+bool rb_mpsc_push_back_F( Ring_Buffer_MPSC_Float_t* p_buf, float value )
+{
+    return rb_mpsc_write_F( p_buf, &value, 1 ) == 1;
+}
+
+uint32_t rb_mpsc_read_F( Ring_Buffer_MPSC_Float_t* p_buf, float* p_data, uint32_t count )
+{
+    uint32_t start = atomic_load_explicit( &p_buf->start_index, memory_order_relaxed );
+    uint32_t read  = 0;
+
+    // stop at the first slot that is reserved but not yet written
+    while( read < count ) {
+        Rb_Mpsc_Slot_t* p_slot = &p_buf->slots[( start + read ) & RB_MASK_MPSC];
+        if( atomic_load_explicit( &p_slot->seq, memory_order_acquire ) != start + read + 1 )
+            break;
+        p_data[read] = p_slot->value;
+        read++;
+    }
+
+    // releasing the slots lets producers reserve them again
+    atomic_store_explicit( &p_buf->start_index, start + read, memory_order_release );
+    return read;
+}
+
+/* Sharded lanes */
+void rb_sharded_initialize_F( Ring_Buffer_Sharded_Float_t* p_buf )
+{
+    for( int l = 0; l < RB_SHARDED_MAX_LANES; l++ )
+        rb_spsc_initialize_F( &p_buf->lanes[l] );
+    atomic_init( &p_buf->lane_count, 0 );
+    p_buf->next_lane = 0;
+}
+
+int rb_sharded_add_lane_F( Ring_Buffer_Sharded_Float_t* p_buf )
+{
+    uint32_t lanes = atomic_load( &p_buf->lane_count );
+    do {
+        if( lanes == RB_SHARDED_MAX_LANES )
+            return -1;
+    } while( !atomic_compare_exchange_weak( &p_buf->lane_count, &lanes, lanes + 1 ) );
+
+    return lanes;
+}
+
+bool rb_sharded_push_back_F( Ring_Buffer_Sharded_Float_t* p_buf, int lane, float value )
+{
+    return rb_spsc_push_back_F( &p_buf->lanes[lane], value );
+}
+
+uint32_t rb_sharded_write_F( Ring_Buffer_Sharded_Float_t* p_buf, int lane, const float* p_data, uint32_t count )
+{
+    return rb_spsc_write_F( &p_buf->lanes[lane], p_data, count );
+}
+
+uint32_t rb_sharded_read_F( Ring_Buffer_Sharded_Float_t* p_buf, float* p_data, uint32_t count )
+{
+    uint32_t lanes = atomic_load_explicit( &p_buf->lane_count, memory_order_acquire );
+    uint32_t read  = 0;
+
+    // take an equal share from each lane in turn, starting where the last merge stopped so no lane is starved
+    for( uint32_t k = 0; k < lanes && read < count; k++ ) {
+        uint32_t lane  = ( p_buf->next_lane + k ) % lanes;
+        uint32_t share = ( count - read + ( lanes - k ) - 1 ) / ( lanes - k );
+        read += rb_spsc_read_F( &p_buf->lanes[lane], p_data + read, share );
+    }
+
+    if( lanes > 0 )
+        p_buf->next_lane = ( p_buf->next_lane + 1 ) % lanes;
+
+    return read;
+}
@@ -0,0 +1,106 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/* Ring_Buffer_MPSC.h
+ *
+ * Float queues that many producer threads can push into and one consumer thread drains, without a lock.
+ *
+ * Ring_Buffer_MPSC_Float_t is one shared ring. A producer reserves a run of slots with a single compare and swap on
+ * the reserve counter, copies its data in, and marks each slot with its sequence number. The consumer reads slots in
+ * order for as long as their sequence numbers say they are written, so producers that reserved later may finish
+ * first without the consumer seeing a gap. Pushing into a full queue fails instead of overwriting.
+ *
+ * Ring_Buffer_Sharded_Float_t gives every producer its own lane, a Ring_Buffer_SPSC_Float_t, so producers share no
+ * cache lines at all. The consumer merges the lanes round robin. Order is kept within a lane but not between lanes.
+ *
+ * Functions implemented are as follows:
+ *
+ * rb_mpsc_initialize_F     <-- Initializes the queue for use, not thread safe
+ * rb_mpsc_length_F         <-- Returns the number of reserved elements (approximate while producers run)
+ * rb_mpsc_push_back_F      <-- Producer: appends an element, false if full
+ * rb_mpsc_write_F          <-- Producer: reserves and appends as many elements of an array as fit
+ * rb_mpsc_read_F           <-- Consumer: removes up to count elements into an array
+ *
+ * rb_sharded_initialize_F  <-- Initializes the sharded queue for use, not thread safe
+ * rb_sharded_add_lane_F    <-- Gives the calling producer its own lane
+ * rb_sharded_push_back_F   <-- Producer: appends an element to its lane, false if full
+ * rb_sharded_write_F       <-- Producer: appends as many elements of an array as fit in its lane
+ * rb_sharded_read_F        <-- Consumer: removes up to count elements, merged from all lanes
+ *
+ * Requires C11 atomics, so this is not built for AVR_MCU.
+ * */
+#ifndef RING_BUFFER_MPSC_H
+#define RING_BUFFER_MPSC_H
+
+#include "Ring_Buffer_SPSC.h"
+
+#ifndef RB_LENGTH_MPSC
+#    define RB_LENGTH_MPSC 1024  // must be a power of 2
+#endif
+
+#ifndef RB_SHARDED_MAX_LANES
+#    define RB_SHARDED_MAX_LANES 16
+#endif
+
+// a slot is written once seq equals its position + 1
+typedef struct {
+    _Atomic uint32_t seq;
+    float value;
+} Rb_Mpsc_Slot_t;
+
+// data structure for a multiple producer single consumer float ring buffer
+typedef struct {
+    _Alignas( RB_SPSC_CACHE_LINE ) _Atomic uint32_t reserve_index;  // producers: next position to hand out
+    _Alignas( RB_SPSC_CACHE_LINE ) _Atomic uint32_t start_index;    // consumer: next position to read
+    _Alignas( RB_SPSC_CACHE_LINE ) Rb_Mpsc_Slot_t slots[RB_LENGTH_MPSC];
+} Ring_Buffer_MPSC_Float_t;
+
+// data structure for a queue sharded into one SPSC lane per producer
+typedef struct {
+    Ring_Buffer_SPSC_Float_t lanes[RB_SHARDED_MAX_LANES];
+    _Atomic uint32_t lane_count;
+    uint32_t next_lane;  // consumer: lane the next merge starts from
+} Ring_Buffer_Sharded_Float_t;
+
+/* Shared ring */
+void rb_mpsc_initialize_F( Ring_Buffer_MPSC_Float_t* p_buf );
+uint32_t rb_mpsc_length_F( Ring_Buffer_MPSC_Float_t* p_buf );
+bool rb_mpsc_push_back_F( Ring_Buffer_MPSC_Float_t* p_buf, float value );
+uint32_t rb_mpsc_write_F( Ring_Buffer_MPSC_Float_t* p_buf, const float* p_data, uint32_t count );
+uint32_t rb_mpsc_read_F( Ring_Buffer_MPSC_Float_t* p_buf, float* p_data, uint32_t count );
+
+/* Sharded lanes, add_lane returns the lane id or -1 if all lanes are taken */
+void rb_sharded_initialize_F( Ring_Buffer_Sharded_Float_t* p_buf );
+int rb_sharded_add_lane_F( Ring_Buffer_Sharded_Float_t* p_buf );
+bool rb_sharded_push_back_F( Ring_Buffer_Sharded_Float_t* p_buf, int lane, float value );
+uint32_t rb_sharded_write_F( Ring_Buffer_Sharded_Float_t* p_buf, int lane, const float* p_data, uint32_t count );
+uint32_t rb_sharded_read_F( Ring_Buffer_Sharded_Float_t* p_buf, float* p_data, uint32_t count );
+
+#endif
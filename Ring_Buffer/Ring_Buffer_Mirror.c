@@ -0,0 +1,257 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#define _GNU_SOURCE  // for memfd_create
+#include "Ring_Buffer_Mirror.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+// rounds the element count up to a power of 2 that covers at least one page, 0 if that power of 2 does not fit in
+// 32 bits
+static uint32_t mirror_capacity( uint32_t capacity, size_t element_size )
+{
+    uint32_t minimum = (uint32_t)( sysconf( _SC_PAGESIZE ) / element_size );
+    uint32_t rounded = 1;
+
+    if( capacity > ( UINT32_C( 1 ) << 31 ) )
+        return 0;
+    while( rounded < capacity || rounded < minimum )
+        rounded <<= 1;
+    return rounded;
+}
+
+// maps size bytes of memfd storage twice in a row, NULL on failure
+static void* mirror_map( size_t size )
+{
+    int fd = memfd_create( "ring_buffer_mirror", MFD_CLOEXEC );
+    if( fd < 0 )
+        return NULL;
+
+    // reserve both halves first so nothing else can be mapped between them
+    uint8_t* p_base = mmap( NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if( p_base == MAP_FAILED || ftruncate( fd, (off_t)size ) != 0
+        || mmap( p_base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0 ) == MAP_FAILED
+        || mmap( p_base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0 ) == MAP_FAILED ) {
+        if( p_base != MAP_FAILED )
+            munmap( p_base, 2 * size );
+        close( fd );
+        return NULL;
+    }
+
+    // the mappings keep the memory alive
+    close( fd );
+    return p_base;
+}
+
+/* Initialization */
+bool rb_mirror_initialize_F( Ring_Buffer_Mirror_Float_t* p_buf, uint32_t capacity )
+{
+    p_buf->capacity    = mirror_capacity( capacity, sizeof( float ) );
+    p_buf->start_index = 0;
+    p_buf->end_index   = 0;
+    p_buf->buffer      = ( p_buf->capacity != 0 ) ? mirror_map( (size_t)p_buf->capacity * sizeof( float ) ) : NULL;
+    return p_buf->buffer != NULL;
+}
+bool rb_mirror_initialize_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t capacity )
+{
+    p_buf->capacity    = mirror_capacity( capacity, sizeof( uint8_t ) );
+    p_buf->start_index = 0;
+    p_buf->end_index   = 0;
+    p_buf->buffer      = ( p_buf->capacity != 0 ) ? mirror_map( p_buf->capacity ) : NULL;
+    return p_buf->buffer != NULL;
+}
+
+void rb_mirror_free_F( Ring_Buffer_Mirror_Float_t* p_buf )
+{
+    if( p_buf->buffer != NULL )
+        munmap( p_buf->buffer, 2 * (size_t)p_buf->capacity * sizeof( float ) );
+    p_buf->buffer = NULL;
+}
+void rb_mirror_free_B( Ring_Buffer_Mirror_Byte_t* p_buf )
+{
+    if( p_buf->buffer != NULL )
+        munmap( p_buf->buffer, 2 * (size_t)p_buf->capacity );
+    p_buf->buffer = NULL;
+}
+
+/* Return active Length of Buffer */
+uint32_t rb_mirror_length_F( const Ring_Buffer_Mirror_Float_t* p_buf )
+{
+    return ( p_buf->end_index - p_buf->start_index ) & ( p_buf->capacity - 1 );
+}
+uint32_t rb_mirror_length_B( const Ring_Buffer_Mirror_Byte_t* p_buf )
+{
+    return ( p_buf->end_index - p_buf->start_index ) & ( p_buf->capacity - 1 );
+}
+
+/* Append element to end and lengthen */
+void rb_mirror_push_back_F( Ring_Buffer_Mirror_Float_t* p_buf, float value )
+{
+    // as in rb_push_back_F, a full buffer drops its oldest element
+    p_buf->buffer[p_buf->end_index] = value;
+    p_buf->end_index                = ( p_buf->end_index + 1 ) & ( p_buf->capacity - 1 );
+    if( p_buf->end_index == p_buf->start_index )
+        p_buf->start_index = ( p_buf->start_index + 1 ) & ( p_buf->capacity - 1 );
+}
+void rb_mirror_push_back_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint8_t value )
+{
+    p_buf->buffer[p_buf->end_index] = value;
+    p_buf->end_index                = ( p_buf->end_index + 1 ) & ( p_buf->capacity - 1 );
+    if( p_buf->end_index == p_buf->start_index )
+        p_buf->start_index = ( p_buf->start_index + 1 ) & ( p_buf->capacity - 1 );
+}
+
+/* Append element to front and lengthen */
+void rb_mirror_push_front_F( Ring_Buffer_Mirror_Float_t* p_buf, float value )
+{
+    // a full buffer drops its newest element
+    p_buf->start_index                = ( p_buf->start_index - 1 ) & ( p_buf->capacity - 1 );
+    p_buf->buffer[p_buf->start_index] = value;
+    if( p_buf->end_index == p_buf->start_index )
+        p_buf->end_index = ( p_buf->end_index - 1 ) & ( p_buf->capacity - 1 );
+}
+void rb_mirror_push_front_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint8_t value )
+{
+    p_buf->start_index                = ( p_buf->start_index - 1 ) & ( p_buf->capacity - 1 );
+    p_buf->buffer[p_buf->start_index] = value;
+    if( p_buf->end_index == p_buf->start_index )
+        p_buf->end_index = ( p_buf->end_index - 1 ) & ( p_buf->capacity - 1 );
+}
+
+/* Remove element from end and shorten */
+float rb_mirror_pop_back_F( Ring_Buffer_Mirror_Float_t* p_buf )
+{
+    if( p_buf->end_index == p_buf->start_index )
+        return 0;
+
+    p_buf->end_index = ( p_buf->end_index - 1 ) & ( p_buf->capacity - 1 );
+    return p_buf->buffer[p_buf->end_index];
+}
+uint8_t rb_mirror_pop_back_B( Ring_Buffer_Mirror_Byte_t* p_buf )
+{
+    if( p_buf->end_index == p_buf->start_index )
+        return 0;
+
+    p_buf->end_index = ( p_buf->end_index - 1 ) & ( p_buf->capacity - 1 );
+    return p_buf->buffer[p_buf->end_index];
+}
+
+/* Remove element from start and shorten */
+float rb_mirror_pop_front_F( Ring_Buffer_Mirror_Float_t* p_buf )
+{
+    if( p_buf->end_index == p_buf->start_index )
+        return 0;
+
+    float value        = p_buf->buffer[p_buf->start_index];
+    p_buf->start_index = ( p_buf->start_index + 1 ) & ( p_buf->capacity - 1 );
+    return value;
+}
+uint8_t rb_mirror_pop_front_B( Ring_Buffer_Mirror_Byte_t* p_buf )
+{
+    if( p_buf->end_index == p_buf->start_index )
+        return 0;
+
+    uint8_t value      = p_buf->buffer[p_buf->start_index];
+    p_buf->start_index = ( p_buf->start_index + 1 ) & ( p_buf->capacity - 1 );
+    return value;
+}
+
+/* access element, the second mapping makes start + index valid without masking */
+float rb_mirror_get_F( const Ring_Buffer_Mirror_Float_t* p_buf, uint32_t index )
+{
+    return p_buf->buffer[p_buf->start_index + ( index & ( p_buf->capacity - 1 ) )];
+}
+uint8_t rb_mirror_get_B( const Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t index )
+{
+    return p_buf->buffer[p_buf->start_index + ( index & ( p_buf->capacity - 1 ) )];
+}
+
+/* set element */
+void rb_mirror_set_F( Ring_Buffer_Mirror_Float_t* p_buf, uint32_t index, float value )
+{
+    p_buf->buffer[p_buf->start_index + ( index & ( p_buf->capacity - 1 ) )] = value;
+}
+void rb_mirror_set_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t index, uint8_t value )
+{
+    p_buf->buffer[p_buf->start_index + ( index & ( p_buf->capacity - 1 ) )] = value;
+}
+
+/* contiguous access */
+const float* rb_mirror_view_F( const Ring_Buffer_Mirror_Float_t* p_buf, uint32_t* p_length )
+{
+    *p_length = rb_mirror_length_F( p_buf );
+    return &p_buf->buffer[p_buf->start_index];
+}
+const uint8_t* rb_mirror_view_B( const Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t* p_length )
+{
+    *p_length = rb_mirror_length_B( p_buf );
+    return &p_buf->buffer[p_buf->start_index];
+}
+
+void rb_mirror_consume_F( Ring_Buffer_Mirror_Float_t* p_buf, uint32_t count )
+{
+    // never move start past end
+    if( count > rb_mirror_length_F( p_buf ) )
+        count = rb_mirror_length_F( p_buf );
+    p_buf->start_index = ( p_buf->start_index + count ) & ( p_buf->capacity - 1 );
+}
+void rb_mirror_consume_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t count )
+{
+    if( count > rb_mirror_length_B( p_buf ) )
+        count = rb_mirror_length_B( p_buf );
+    p_buf->start_index = ( p_buf->start_index + count ) & ( p_buf->capacity - 1 );
+}
+
+float* rb_mirror_write_view_F( Ring_Buffer_Mirror_Float_t* p_buf, uint32_t* p_free )
+{
+    // one slot always stays empty so a full buffer is distinguishable from an empty one
+    *p_free = p_buf->capacity - 1 - rb_mirror_length_F( p_buf );
+    return &p_buf->buffer[p_buf->end_index];
+}
+uint8_t* rb_mirror_write_view_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t* p_free )
+{
+    *p_free = p_buf->capacity - 1 - rb_mirror_length_B( p_buf );
+    return &p_buf->buffer[p_buf->end_index];
+}
+
+void rb_mirror_commit_F( Ring_Buffer_Mirror_Float_t* p_buf, uint32_t count )
+{
+    // never move end onto start
+    if( count > p_buf->capacity - 1 - rb_mirror_length_F( p_buf ) )
+        count = p_buf->capacity - 1 - rb_mirror_length_F( p_buf );
+    p_buf->end_index = ( p_buf->end_index + count ) & ( p_buf->capacity - 1 );
+}
+void rb_mirror_commit_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t count )
+{
+    if( count > p_buf->capacity - 1 - rb_mirror_length_B( p_buf ) )
+        count = p_buf->capacity - 1 - rb_mirror_length_B( p_buf );
+    p_buf->end_index = ( p_buf->end_index + count ) & ( p_buf->capacity - 1 );
+}
@@ -0,0 +1,135 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/* Ring_Buffer_Mirror.h
+ *
+ * Byte and float ring buffers whose storage is mapped twice back to back in virtual memory: the same memfd pages
+ * appear at buffer[0 .. capacity) and again at buffer[capacity .. 2 * capacity). Any run of up to capacity elements
+ * starting at start_index is therefore contiguous, so consumers can hand rb_mirror_view_X straight to memchr, memcpy
+ * or vector loads without special casing the wrap point.
+ *
+ * The functions follow the rb_* API of Ring_Buffer_Float_t and Ring_Buffer_Byte_t, including overwriting the oldest
+ * element when pushing into a full buffer, with these differences:
+ *  - the capacity is chosen at run time and rounded up to a power of 2 that fills at least one page, so the length
+ *    and indices are uint32_t.
+ *  - the storage must be created with rb_mirror_initialize_X and released with rb_mirror_free_X.
+ *  - rb_mirror_view_X and rb_mirror_write_view_X return every active element or all free space in one pointer, where
+ *    rb_read_span_X and rb_write_span_X stop at the wrap point.
+ *
+ * Functions implemented are as follows (where X is either F or B to denote float or uint8_t/byte):
+ *
+ * rb_mirror_initialize_X  <-- Maps the storage, false if the mapping failed
+ * rb_mirror_free_X        <-- Unmaps the storage
+ * rb_mirror_length_X      <-- Returns the number of active elements
+ * rb_mirror_push_back_X   <-- Appends an element to the end of the buffer
+ * rb_mirror_push_front_X  <-- Appends an element to the start of the buffer
+ * rb_mirror_pop_back_X    <-- Removes and returns the last element
+ * rb_mirror_pop_front_X   <-- Removes and returns the first element
+ * rb_mirror_get_X         <-- Returns an desired element from within the buffer
+ * rb_mirror_set_X         <-- Sets a desired element within the buffer
+ * rb_mirror_view_X        <-- Returns a pointer to all active elements, contiguous
+ * rb_mirror_consume_X     <-- Removes elements from the start after they were read through the view
+ * rb_mirror_write_view_X  <-- Returns a pointer to all free space, contiguous
+ * rb_mirror_commit_X      <-- Adds elements to the end after they were written through the write view
+ *
+ * Linux only (memfd_create); not built for AVR_MCU.
+ * */
+#ifndef RING_BUFFER_MIRROR_H
+#define RING_BUFFER_MIRROR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// data structure for a mirrored float ring buffer
+typedef struct {
+    float* buffer;  // 2 * capacity elements of address space, capacity of storage
+    uint32_t capacity;
+    uint32_t start_index;
+    uint32_t end_index;
+} Ring_Buffer_Mirror_Float_t;
+
+// data structure for a mirrored uint8_t ring buffer
+typedef struct {
+    uint8_t* buffer;
+    uint32_t capacity;
+    uint32_t start_index;
+    uint32_t end_index;
+} Ring_Buffer_Mirror_Byte_t;
+
+/* Initialization, capacity is a minimum. False if the mapping failed or capacity is above 2^31, the largest power of 2
+   that fits the uint32_t indices */
+bool rb_mirror_initialize_F( Ring_Buffer_Mirror_Float_t* p_buf, uint32_t capacity );
+bool rb_mirror_initialize_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t capacity );
+
+void rb_mirror_free_F( Ring_Buffer_Mirror_Float_t* p_buf );
+void rb_mirror_free_B( Ring_Buffer_Mirror_Byte_t* p_buf );
+
+/* Return active Length of Buffer */
+uint32_t rb_mirror_length_F( const Ring_Buffer_Mirror_Float_t* p_buf );
+uint32_t rb_mirror_length_B( const Ring_Buffer_Mirror_Byte_t* p_buf );
+
+/* Append element to end and lengthen */
+void rb_mirror_push_back_F( Ring_Buffer_Mirror_Float_t* p_buf, float value );
+void rb_mirror_push_back_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint8_t value );
+
+/* Append element to front and lengthen */
+void rb_mirror_push_front_F( Ring_Buffer_Mirror_Float_t* p_buf, float value );
+void rb_mirror_push_front_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint8_t value );
+
+/* Remove element from end and shorten */
+float rb_mirror_pop_back_F( Ring_Buffer_Mirror_Float_t* p_buf );
+uint8_t rb_mirror_pop_back_B( Ring_Buffer_Mirror_Byte_t* p_buf );
+
+/* Remove element from start and shorten */
+float rb_mirror_pop_front_F( Ring_Buffer_Mirror_Float_t* p_buf );
+uint8_t rb_mirror_pop_front_B( Ring_Buffer_Mirror_Byte_t* p_buf );
+
+/* access element */
+float rb_mirror_get_F( const Ring_Buffer_Mirror_Float_t* p_buf, uint32_t index );
+uint8_t rb_mirror_get_B( const Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t index );
+
+/* set element - poorly defined if index is outside of active length, as for rb_set_X */
+void rb_mirror_set_F( Ring_Buffer_Mirror_Float_t* p_buf, uint32_t index, float value );
+void rb_mirror_set_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t index, uint8_t value );
+
+/* contiguous access, never split at the wrap point. Writing through the view never overwrites active elements */
+const float* rb_mirror_view_F( const Ring_Buffer_Mirror_Float_t* p_buf, uint32_t* p_length );
+const uint8_t* rb_mirror_view_B( const Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t* p_length );
+
+void rb_mirror_consume_F( Ring_Buffer_Mirror_Float_t* p_buf, uint32_t count );
+void rb_mirror_consume_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t count );
+
+float* rb_mirror_write_view_F( Ring_Buffer_Mirror_Float_t* p_buf, uint32_t* p_free );
+uint8_t* rb_mirror_write_view_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t* p_free );
+
+void rb_mirror_commit_F( Ring_Buffer_Mirror_Float_t* p_buf, uint32_t count );
+void rb_mirror_commit_B( Ring_Buffer_Mirror_Byte_t* p_buf, uint32_t count );
+
+#endif
@@ -0,0 +1,251 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Ring_Buffer_Recorder.h"
+
+#include <fcntl.h>
+#include <string.h>  // for memcpy and memmove
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+_Static_assert( sizeof( Rb_Recorder_Header_t ) == 64, "the samples start one cache line into the file" );
+
+static size_t recorder_size( uint32_t capacity )
+{
+    return sizeof( Rb_Recorder_Header_t ) + (size_t)capacity * sizeof( float );
+}
+
+static bool recorder_map( Ring_Buffer_Recorder_Float_t* p_rec, int fd, size_t size, bool writable )
+{
+    void* p_map = mmap( NULL, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0 );
+    if( p_map == MAP_FAILED )
+        return false;
+
+    p_rec->p_header = p_map;
+    p_rec->buffer   = (float*)( p_rec->p_header + 1 );
+    p_rec->map_size = size;
+    return true;
+}
+
+/* File management */
+bool rb_recorder_open_F( Ring_Buffer_Recorder_Float_t* p_rec, const char* path, uint32_t capacity, uint32_t sync_interval )
+{
+    if( capacity == 0 || ( capacity & ( capacity - 1 ) ) != 0 )
+        return false;
+
+    int fd = open( path, O_RDWR | O_CREAT, 0644 );
+    if( fd < 0 )
+        return false;
+
+    // an empty file is new, anything else must already be exactly this size and is checked once mapped
+    struct stat info;
+    bool ok = fstat( fd, &info ) == 0;
+    if( ok && info.st_size == 0 )
+        ok = ftruncate( fd, (off_t)recorder_size( capacity ) ) == 0;
+    else
+        ok = ok && (size_t)info.st_size == recorder_size( capacity );
+
+    bool mapped = ok && recorder_map( p_rec, fd, recorder_size( capacity ), true );
+    close( fd );
+    if( !mapped )
+        return false;
+
+    // magic is written last when creating, so 0 is a file whose creation was cut short rather than someone else's data
+    Rb_Recorder_Header_t* p_header = p_rec->p_header;
+    if( p_header->magic == RB_RECORDER_MAGIC ) {
+        if( p_header->version != RB_RECORDER_VERSION || p_header->capacity != capacity ) {
+            munmap( p_rec->p_header, p_rec->map_size );
+            return false;
+        }
+        p_header->generation++;
+    } else if( p_header->magic == 0 ) {
+        memset( p_header, 0, sizeof( *p_header ) );
+        p_header->version  = RB_RECORDER_VERSION;
+        p_header->capacity = capacity;
+        atomic_init( &p_header->sequence, 0 );
+        atomic_init( &p_header->claimed, 0 );
+        p_header->magic = RB_RECORDER_MAGIC;  // last, a file cut short while creating is not mistaken for a recording
+    } else {
+        munmap( p_rec->p_header, p_rec->map_size );
+        return false;
+    }
+
+    p_rec->mask          = capacity - 1;
+    p_rec->sync_interval = sync_interval;
+    p_rec->until_sync    = sync_interval;
+    return true;
+}
+
+bool rb_recorder_attach_F( Ring_Buffer_Recorder_Float_t* p_rec, const char* path )
+{
+    int fd = open( path, O_RDONLY );
+    if( fd < 0 )
+        return false;
+
+    struct stat info;
+    bool mapped = fstat( fd, &info ) == 0 && (size_t)info.st_size >= sizeof( Rb_Recorder_Header_t )
+                  && recorder_map( p_rec, fd, (size_t)info.st_size, false );
+    close( fd );
+    if( !mapped )
+        return false;
+
+    const Rb_Recorder_Header_t* p_header = p_rec->p_header;
+    if( p_header->magic != RB_RECORDER_MAGIC || p_header->version != RB_RECORDER_VERSION || p_header->capacity == 0
+        || ( p_header->capacity & ( p_header->capacity - 1 ) ) != 0 || recorder_size( p_header->capacity ) != p_rec->map_size ) {
+        munmap( p_rec->p_header, p_rec->map_size );
+        return false;
+    }
+
+    p_rec->mask          = p_header->capacity - 1;
+    p_rec->sync_interval = 0;
+    p_rec->until_sync    = 0;
+    return true;
+}
+
+void rb_recorder_close_F( Ring_Buffer_Recorder_Float_t* p_rec )
+{
+    if( p_rec->sync_interval != 0 )
+        rb_recorder_sync_F( p_rec );
+    munmap( p_rec->p_header, p_rec->map_size );
+    p_rec->p_header = NULL;
+    p_rec->buffer   = NULL;
+}
+
+int rb_recorder_sync_F( Ring_Buffer_Recorder_Float_t* p_rec )
+{
+    p_rec->until_sync = p_rec->sync_interval;
+    return msync( p_rec->p_header, p_rec->map_size, MS_SYNC );
+}
+
+/* Writing */
+
+// marks the slots up to end as being overwritten before any of them is stored to. claimed only ever grows, so the
+// samples a write cut short by a crash may have hit stay excluded until the sequence has moved past them.
+static void recorder_claim( Ring_Buffer_Recorder_Float_t* p_rec, uint64_t end )
+{
+    if( end > atomic_load_explicit( &p_rec->p_header->claimed, memory_order_relaxed ) )
+        atomic_store_explicit( &p_rec->p_header->claimed, end, memory_order_relaxed );
+    atomic_thread_fence( memory_order_release );
+}
+
+void rb_recorder_push_back_F( Ring_Buffer_Recorder_Float_t* p_rec, float value )
+{
+    // only this process writes the sequence, so the relaxed load sees its own last store
+    uint64_t sequence = atomic_load_explicit( &p_rec->p_header->sequence, memory_order_relaxed );
+
+    recorder_claim( p_rec, sequence + 1 );
+    p_rec->buffer[sequence & p_rec->mask] = value;
+    atomic_store_explicit( &p_rec->p_header->sequence, sequence + 1, memory_order_release );
+
+    if( p_rec->sync_interval != 0 && --p_rec->until_sync == 0 )
+        rb_recorder_sync_F( p_rec );
+}
+
+void rb_recorder_write_F( Ring_Buffer_Recorder_Float_t* p_rec, const float* p_data, uint32_t count )
+{
+    uint64_t sequence = atomic_load_explicit( &p_rec->p_header->sequence, memory_order_relaxed );
+    uint32_t capacity = p_rec->mask + 1;
+
+    // more than a full buffer only leaves the last capacity samples
+    if( count > capacity ) {
+        sequence += count - capacity;
+        p_data += count - capacity;
+        count = capacity;
+    }
+
+    recorder_claim( p_rec, sequence + count );
+
+    // at most two copies, one either side of the wrap point
+    uint32_t end     = sequence & p_rec->mask;
+    uint32_t to_wrap = capacity - end;
+    uint32_t first   = ( count < to_wrap ) ? count : to_wrap;
+    memcpy( &p_rec->buffer[end], p_data, first * sizeof( float ) );
+    memcpy( p_rec->buffer, p_data + first, ( count - first ) * sizeof( float ) );
+    atomic_store_explicit( &p_rec->p_header->sequence, sequence + count, memory_order_release );
+
+    if( p_rec->sync_interval != 0 ) {
+        if( count >= p_rec->until_sync )
+            rb_recorder_sync_F( p_rec );
+        else
+            p_rec->until_sync -= count;
+    }
+}
+
+/* Reading */
+
+// number of intact samples ending at sequence: at most capacity, less any a write up to claimed may have overwritten
+static uint32_t recorder_length( const Ring_Buffer_Recorder_Float_t* p_rec, uint64_t sequence, uint64_t claimed )
+{
+    uint64_t capacity = (uint64_t)p_rec->mask + 1;
+    uint64_t oldest   = ( sequence > capacity ) ? sequence - capacity : 0;
+
+    if( claimed > capacity && claimed - capacity > oldest )
+        oldest = claimed - capacity;
+    return ( oldest < sequence ) ? (uint32_t)( sequence - oldest ) : 0;
+}
+
+uint32_t rb_recorder_length_F( const Ring_Buffer_Recorder_Float_t* p_rec )
+{
+    uint64_t sequence = atomic_load_explicit( &p_rec->p_header->sequence, memory_order_acquire );
+    uint64_t claimed  = atomic_load_explicit( &p_rec->p_header->claimed, memory_order_acquire );
+    return recorder_length( p_rec, sequence, claimed );
+}
+
+float rb_recorder_get_F( const Ring_Buffer_Recorder_Float_t* p_rec, uint32_t index )
+{
+    uint64_t sequence = atomic_load_explicit( &p_rec->p_header->sequence, memory_order_acquire );
+    uint64_t claimed  = atomic_load_explicit( &p_rec->p_header->claimed, memory_order_acquire );
+    uint64_t oldest   = sequence - recorder_length( p_rec, sequence, claimed );
+    return p_rec->buffer[( oldest + index ) & p_rec->mask];
+}
+
+uint32_t rb_recorder_copy_F( const Ring_Buffer_Recorder_Float_t* p_rec, float* p_data, uint32_t count )
+{
+    uint64_t sequence = atomic_load_explicit( &p_rec->p_header->sequence, memory_order_acquire );
+    uint64_t claimed  = atomic_load_explicit( &p_rec->p_header->claimed, memory_order_acquire );
+    if( count > recorder_length( p_rec, sequence, claimed ) )
+        count = recorder_length( p_rec, sequence, claimed );
+
+    uint32_t start   = ( sequence - count ) & p_rec->mask;
+    uint32_t to_wrap = p_rec->mask + 1 - start;
+    uint32_t first   = ( count < to_wrap ) ? count : to_wrap;
+    memcpy( p_data, &p_rec->buffer[start], first * sizeof( float ) );
+    memcpy( p_data + first, p_rec->buffer, ( count - first ) * sizeof( float ) );
+
+    // a write that started during the copy may have overwritten the oldest samples copied, drop those
+    atomic_thread_fence( memory_order_acquire );
+    uint32_t intact = recorder_length( p_rec, sequence, atomic_load_explicit( &p_rec->p_header->claimed, memory_order_relaxed ) );
+    if( intact < count ) {
+        memmove( p_data, p_data + ( count - intact ), intact * sizeof( float ) );
+        count = intact;
+    }
+    return count;
+}
@@ -0,0 +1,111 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/* Ring_Buffer_Recorder.h
+ *
+ * A float ring buffer kept in a memory mapped file, so the last capacity samples survive a crash of the process that
+ * recorded them and can be read afterwards by a post-mortem tool.
+ *
+ * The file holds a small header followed by the samples. The header stores the capacity and a sequence number that
+ * counts every sample ever pushed; the end index is sequence & mask and the start is capacity samples before it
+ * once the buffer has filled. Once full, the slots a push or write fills hold the oldest samples, so before touching
+ * them the writer raises claimed, the end of the write in progress, and only then stores the samples and the new
+ * sequence with release ordering. Readers treat every sample below claimed - capacity as gone, so neither a reader
+ * running alongside the writer nor a post-mortem reader after a crash part way through a write ever sees a new
+ * value in place of an old one. The page cache makes the data durable against a process crash. For power loss, set
+ * sync_interval to msync the mapping every sync_interval pushes, or call rb_recorder_sync_F at convenient points.
+ *
+ * Opening an existing recording with the same capacity continues it and increments the generation in the header, so
+ * a reader can tell how many times the recorder was restarted. rb_recorder_open_F fails, leaving the file untouched,
+ * if the file already holds anything other than a recording of that capacity; only an empty file, or one whose
+ * creation was cut short before the header was written, is initialized.
+ *
+ * Functions implemented are as follows:
+ *
+ * rb_recorder_open_F       <-- Opens or creates a recording for writing
+ * rb_recorder_attach_F     <-- Opens a recording read only, e.g. after a crash
+ * rb_recorder_close_F      <-- Syncs if configured and unmaps
+ * rb_recorder_push_back_F  <-- Appends a sample, overwriting the oldest once full
+ * rb_recorder_write_F      <-- Appends an array of samples
+ * rb_recorder_length_F     <-- Number of samples held
+ * rb_recorder_get_F        <-- Sample by index, 0 is the oldest, for a recording that is not being written
+ * rb_recorder_copy_F       <-- Copies the newest samples out, oldest first, safe alongside the writer
+ * rb_recorder_sync_F       <-- Flushes the mapping to the file
+ *
+ * POSIX only; not built for AVR_MCU.
+ * */
+#ifndef RING_BUFFER_RECORDER_H
+#define RING_BUFFER_RECORDER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define RB_RECORDER_MAGIC   0x52425246u  // "RBRF"
+#define RB_RECORDER_VERSION 1
+
+// layout at the start of the file, the samples follow at offset sizeof( Rb_Recorder_Header_t )
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;  // power of 2
+    uint32_t generation;
+    _Atomic uint64_t sequence;  // samples pushed since the file was created
+    _Atomic uint64_t claimed;   // end of the latest write started, samples below claimed - capacity are overwritten
+    uint8_t reserved[32];       // pads the header to a cache line
+} Rb_Recorder_Header_t;
+
+// per-process handle on a mapped recording
+typedef struct {
+    Rb_Recorder_Header_t* p_header;
+    float* buffer;
+    uint32_t mask;
+    size_t map_size;
+    uint32_t sync_interval;  // pushes between msync calls, 0 never syncs
+    uint32_t until_sync;
+} Ring_Buffer_Recorder_Float_t;
+
+/* File management, capacity must be a power of 2. Return false on failure */
+bool rb_recorder_open_F( Ring_Buffer_Recorder_Float_t* p_rec, const char* path, uint32_t capacity, uint32_t sync_interval );
+bool rb_recorder_attach_F( Ring_Buffer_Recorder_Float_t* p_rec, const char* path );
+void rb_recorder_close_F( Ring_Buffer_Recorder_Float_t* p_rec );
+int rb_recorder_sync_F( Ring_Buffer_Recorder_Float_t* p_rec );
+
+/* Writing */
+void rb_recorder_push_back_F( Ring_Buffer_Recorder_Float_t* p_rec, float value );
+void rb_recorder_write_F( Ring_Buffer_Recorder_Float_t* p_rec, const float* p_data, uint32_t count );
+
+/* Reading */
+uint32_t rb_recorder_length_F( const Ring_Buffer_Recorder_Float_t* p_rec );
+float rb_recorder_get_F( const Ring_Buffer_Recorder_Float_t* p_rec, uint32_t index );
+uint32_t rb_recorder_copy_F( const Ring_Buffer_Recorder_Float_t* p_rec, float* p_data, uint32_t count );
+
+#endif
@@ -0,0 +1,183 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Ring_Buffer_SPSC.h"
+
+_Static_assert( ( RB_LENGTH_SPSC & ( RB_LENGTH_SPSC - 1 ) ) == 0, "RB_LENGTH_SPSC must be a power of 2" );
+
+/* Initialization */
+void rb_spsc_initialize_F( Ring_Buffer_SPSC_Float_t* p_buf )
+{
+    rb_spsc_index_initialize( &p_buf->index );
+}
+
+/* Return active Length of Buffer */
+uint32_t rb_spsc_length_F( Ring_Buffer_SPSC_Float_t* p_buf )
+{
+    return rb_spsc_index_length( &p_buf->index );
+}
+
+/* contiguous access */
+uint32_t rb_spsc_read_span_F( Ring_Buffer_SPSC_Float_t* p_buf, const float** pp_data )
+{
+    uint32_t slot;
+    uint32_t span = rb_spsc_index_read_span( &p_buf->index, RB_LENGTH_SPSC, &slot );
+
+    *pp_data = &p_buf->buffer[slot];
+    return span;
+}
+
+void rb_spsc_consume_F( Ring_Buffer_SPSC_Float_t* p_buf, uint32_t count )
+{
+    rb_spsc_index_consume( &p_buf->index, count );
+}
+
+uint32_t rb_spsc_write_span_F( Ring_Buffer_SPSC_Float_t* p_buf, float** pp_data )
+{
+    uint32_t slot;
+    uint32_t span = rb_spsc_index_write_span( &p_buf->index, RB_LENGTH_SPSC, &slot );
+
+    *pp_data = &p_buf->buffer[slot];
+    return span;
+}
+
+void rb_spsc_commit_F( Ring_Buffer_SPSC_Float_t* p_buf, uint32_t count )
+{
+    rb_spsc_index_commit( &p_buf->index, count );
+}
+
+/* Single element access */
+bool rb_spsc_push_back_F( Ring_Buffer_SPSC_Float_t* p_buf, float value )
+{
+    float* p_slot;
+    if( rb_spsc_write_span_F( p_buf, &p_slot ) == 0 )
+        return false;
+
+    *p_slot = value;
+    rb_spsc_commit_F( p_buf, 1 );
+    return true;
+}
+
+bool rb_spsc_pop_front_F( Ring_Buffer_SPSC_Float_t* p_buf, float* p_value )
+{
+    const float* p_slot;
+    if( rb_spsc_read_span_F( p_buf, &p_slot ) == 0 )
+        return false;
+
+    *p_value = *p_slot;
+    rb_spsc_consume_F( p_buf, 1 );
+    return true;
+}
+
+/* Bulk access */
+uint32_t rb_spsc_write_F( Ring_Buffer_SPSC_Float_t* p_buf, const float* p_data, uint32_t count )
+{
+    return rb_spsc_index_write( &p_buf->index, RB_LENGTH_SPSC, p_buf->buffer, sizeof( float ), p_data, count );
+}
+
+uint32_t rb_spsc_read_F( Ring_Buffer_SPSC_Float_t* p_buf, float* p_data, uint32_t count )
+{
+    return rb_spsc_index_read( &p_buf->index, RB_LENGTH_SPSC, p_buf->buffer, sizeof( float ), p_data, count );
+}
+
+/* Initialization */
+void rb_spsc_initialize_B( Ring_Buffer_SPSC_Byte_t* p_buf )
+{
+    rb_spsc_index_initialize( &p_buf->index );
+}
+
+/* Return active Length of Buffer */
+uint32_t rb_spsc_length_B( Ring_Buffer_SPSC_Byte_t* p_buf )
+{
+    return rb_spsc_index_length( &p_buf->index );
+}
+
+/* contiguous access */
+uint32_t rb_spsc_read_span_B( Ring_Buffer_SPSC_Byte_t* p_buf, const uint8_t** pp_data )
+{
+    uint32_t slot;
+    uint32_t span = rb_spsc_index_read_span( &p_buf->index, RB_LENGTH_SPSC, &slot );
+
+    *pp_data = &p_buf->buffer[slot];
+    return span;
+}
+
+void rb_spsc_consume_B( Ring_Buffer_SPSC_Byte_t* p_buf, uint32_t count )
+{
+    rb_spsc_index_consume( &p_buf->index, count );
+}
+
+uint32_t rb_spsc_write_span_B( Ring_Buffer_SPSC_Byte_t* p_buf, uint8_t** pp_data )
+{
+    uint32_t slot;
+    uint32_t span = rb_spsc_index_write_span( &p_buf->index, RB_LENGTH_SPSC, &slot );
+
+    *pp_data = &p_buf->buffer[slot];
+    return span;
+}
+
+void rb_spsc_commit_B( Ring_Buffer_SPSC_Byte_t* p_buf, uint32_t count )
+{
+    rb_spsc_index_commit( &p_buf->index, count );
+}
+
+/* Single element access */
+bool rb_spsc_push_back_B( Ring_Buffer_SPSC_Byte_t* p_buf, uint8_t value )
+{
+    uint8_t* p_slot;
+    if( rb_spsc_write_span_B( p_buf, &p_slot ) == 0 )
+        return false;
+
+    *p_slot = value;
+    rb_spsc_commit_B( p_buf, 1 );
+    return true;
+}
+
+bool rb_spsc_pop_front_B( Ring_Buffer_SPSC_Byte_t* p_buf, uint8_t* p_value )
+{
+    const uint8_t* p_slot;
+    if( rb_spsc_read_span_B( p_buf, &p_slot ) == 0 )
+        return false;
+
+    *p_value = *p_slot;
+    rb_spsc_consume_B( p_buf, 1 );
+    return true;
+}
+
+/* Bulk access */
+uint32_t rb_spsc_write_B( Ring_Buffer_SPSC_Byte_t* p_buf, const uint8_t* p_data, uint32_t count )
+{
+    return rb_spsc_index_write( &p_buf->index, RB_LENGTH_SPSC, p_buf->buffer, sizeof( uint8_t ), p_data, count );
+}
+
+uint32_t rb_spsc_read_B( Ring_Buffer_SPSC_Byte_t* p_buf, uint8_t* p_data, uint32_t count )
+{
+    return rb_spsc_index_read( &p_buf->index, RB_LENGTH_SPSC, p_buf->buffer, sizeof( uint8_t ), p_data, count );
+}
@@ -0,0 +1,228 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+/* Ring_Buffer_SPSC.h
+ *
+ * Float and byte ring buffers that one producer thread and one consumer thread can use at the same time without locks.
+ *
+ * They differ from Ring_Buffer_Float_t and Ring_Buffer_Byte_t where concurrency requires it:
+ *  - start and end are free running 32 bit atomic counters on separate cache lines; the producer only writes end and
+ *    the consumer only writes start, each publishing with release ordering.
+ *  - pushing into a full buffer fails instead of overwriting, which is the back-pressure signal for the producer.
+ *  - each side caches the other side's counter and only re-reads it when the cached value says it is blocked.
+ *  - the length is set by RB_LENGTH_SPSC and is not limited to 256. All RB_LENGTH_SPSC slots are usable.
+ *
+ * The index handling lives in Rb_SPSC_Index_t and the rb_spsc_index_* inline helpers, which take the element storage
+ * and capacity separately so rings whose storage is not a fixed array (Ring_Buffer_Shm) share the same code.
+ *
+ * Functions implemented are as follows, each with an _F (float) and _B (byte) version:
+ *
+ * rb_spsc_initialize    <-- Initializes the ring buffer for use, not thread safe
+ * rb_spsc_length        <-- Returns the number of active elements (exact for either side, approximate for others)
+ * rb_spsc_push_back     <-- Producer: appends an element, false if full
+ * rb_spsc_pop_front     <-- Consumer: removes the first element, false if empty
+ * rb_spsc_write         <-- Producer: appends as many elements of an array as fit
+ * rb_spsc_read          <-- Consumer: removes up to count elements into an array
+ * rb_spsc_read_span     <-- Consumer: contiguous run of active elements, released with rb_spsc_consume
+ * rb_spsc_write_span    <-- Producer: contiguous run of free space, published with rb_spsc_commit
+ *
+ * Requires C11 atomics, so this is not built for AVR_MCU.
+ * */
+#ifndef RING_BUFFER_SPSC_H
+#define RING_BUFFER_SPSC_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>  // for memcpy
+
+#ifndef RB_LENGTH_SPSC
+#    define RB_LENGTH_SPSC 1024  // must be a power of 2
+#endif
+
+#define RB_SPSC_CACHE_LINE 64
+
+// shared start/end counters of a single producer single consumer ring
+typedef struct {
+    // consumer side
+    _Alignas( RB_SPSC_CACHE_LINE ) _Atomic uint32_t start_index;
+    uint32_t cached_end;  // consumer's last view of end_index
+
+    // producer side
+    _Alignas( RB_SPSC_CACHE_LINE ) _Atomic uint32_t end_index;
+    uint32_t cached_start;  // producer's last view of start_index
+} Rb_SPSC_Index_t;
+
+// data structure for a single producer single consumer float ring buffer
+typedef struct {
+    Rb_SPSC_Index_t index;
+    _Alignas( RB_SPSC_CACHE_LINE ) float buffer[RB_LENGTH_SPSC];
+} Ring_Buffer_SPSC_Float_t;
+
+// data structure for a single producer single consumer byte ring buffer
+typedef struct {
+    Rb_SPSC_Index_t index;
+    _Alignas( RB_SPSC_CACHE_LINE ) uint8_t buffer[RB_LENGTH_SPSC];
+} Ring_Buffer_SPSC_Byte_t;
+
+/* Index helpers, capacity must be a power of 2 */
+static inline void rb_spsc_index_initialize( Rb_SPSC_Index_t* p_index )
+{
+    atomic_init( &p_index->start_index, 0 );
+    atomic_init( &p_index->end_index, 0 );
+    p_index->cached_end   = 0;
+    p_index->cached_start = 0;
+}
+
+static inline uint32_t rb_spsc_index_length( Rb_SPSC_Index_t* p_index )
+{
+    // the counters run freely, so the difference is the length even across 32 bit wrap
+    return atomic_load_explicit( &p_index->end_index, memory_order_acquire ) - atomic_load_explicit( &p_index->start_index, memory_order_acquire );
+}
+
+// consumer: number of contiguous active elements starting at slot *p_slot
+static inline uint32_t rb_spsc_index_read_span( Rb_SPSC_Index_t* p_index, uint32_t capacity, uint32_t* p_slot )
+{
+    uint32_t start = atomic_load_explicit( &p_index->start_index, memory_order_relaxed );
+
+    // only go to the shared counter when the cached one says there is nothing to read
+    if( p_index->cached_end == start )
+        p_index->cached_end = atomic_load_explicit( &p_index->end_index, memory_order_acquire );
+
+    uint32_t avail   = p_index->cached_end - start;
+    uint32_t to_wrap = capacity - ( start & ( capacity - 1 ) );
+
+    *p_slot = start & ( capacity - 1 );
+    return ( avail < to_wrap ) ? avail : to_wrap;
+}
+
+static inline void rb_spsc_index_consume( Rb_SPSC_Index_t* p_index, uint32_t count )
+{
+    uint32_t start = atomic_load_explicit( &p_index->start_index, memory_order_relaxed );
+    atomic_store_explicit( &p_index->start_index, start + count, memory_order_release );
+}
+
+// producer: number of contiguous free slots starting at slot *p_slot
+static inline uint32_t rb_spsc_index_write_span( Rb_SPSC_Index_t* p_index, uint32_t capacity, uint32_t* p_slot )
+{
+    uint32_t end = atomic_load_explicit( &p_index->end_index, memory_order_relaxed );
+
+    if( end - p_index->cached_start == capacity )
+        p_index->cached_start = atomic_load_explicit( &p_index->start_index, memory_order_acquire );
+
+    uint32_t space   = capacity - ( end - p_index->cached_start );
+    uint32_t to_wrap = capacity - ( end & ( capacity - 1 ) );
+
+    *p_slot = end & ( capacity - 1 );
+    return ( space < to_wrap ) ? space : to_wrap;
+}
+
+static inline void rb_spsc_index_commit( Rb_SPSC_Index_t* p_index, uint32_t count )
+{
+    uint32_t end = atomic_load_explicit( &p_index->end_index, memory_order_relaxed );
+    atomic_store_explicit( &p_index->end_index, end + count, memory_order_release );
+}
+
+// producer: copies up to count elements of elem_size bytes into p_storage, returning the number written
+static inline uint32_t rb_spsc_index_write( Rb_SPSC_Index_t* p_index, uint32_t capacity, void* p_storage, size_t elem_size, const void* p_data,
+                                            uint32_t count )
+{
+    uint32_t written = 0;
+
+    // at most two spans, one either side of the wrap point
+    while( written < count ) {
+        uint32_t slot;
+        uint32_t span = rb_spsc_index_write_span( p_index, capacity, &slot );
+        if( span == 0 )
+            break;
+        if( span > count - written )
+            span = count - written;
+
+        memcpy( (uint8_t*)p_storage + slot * elem_size, (const uint8_t*)p_data + written * elem_size, span * elem_size );
+        rb_spsc_index_commit( p_index, span );
+        written += span;
+    }
+
+    return written;
+}
+
+// consumer: copies up to count elements of elem_size bytes out of p_storage, returning the number read
+static inline uint32_t rb_spsc_index_read( Rb_SPSC_Index_t* p_index, uint32_t capacity, const void* p_storage, size_t elem_size, void* p_data,
+                                           uint32_t count )
+{
+    uint32_t read = 0;
+
+    while( read < count ) {
+        uint32_t slot;
+        uint32_t span = rb_spsc_index_read_span( p_index, capacity, &slot );
+        if( span == 0 )
+            break;
+        if( span > count - read )
+            span = count - read;
+
+        memcpy( (uint8_t*)p_data + read * elem_size, (const uint8_t*)p_storage + slot * elem_size, span * elem_size );
+        rb_spsc_index_consume( p_index, span );
+        read += span;
+    }
+
+    return read;
+}
+
+/* Initialization */
+void rb_spsc_initialize_F( Ring_Buffer_SPSC_Float_t* p_buf );
+void rb_spsc_initialize_B( Ring_Buffer_SPSC_Byte_t* p_buf );
+
+/* Return active Length of Buffer */
+uint32_t rb_spsc_length_F( Ring_Buffer_SPSC_Float_t* p_buf );
+uint32_t rb_spsc_length_B( Ring_Buffer_SPSC_Byte_t* p_buf );
+
+/* Single element access */
+bool rb_spsc_push_back_F( Ring_Buffer_SPSC_Float_t* p_buf, float value );
+bool rb_spsc_pop_front_F( Ring_Buffer_SPSC_Float_t* p_buf, float* p_value );
+bool rb_spsc_push_back_B( Ring_Buffer_SPSC_Byte_t* p_buf, uint8_t value );
+bool rb_spsc_pop_front_B( Ring_Buffer_SPSC_Byte_t* p_buf, uint8_t* p_value );
+
+/* Bulk access, returning the number of elements moved */
+uint32_t rb_spsc_write_F( Ring_Buffer_SPSC_Float_t* p_buf, const float* p_data, uint32_t count );
+uint32_t rb_spsc_read_F( Ring_Buffer_SPSC_Float_t* p_buf, float* p_data, uint32_t count );
+uint32_t rb_spsc_write_B( Ring_Buffer_SPSC_Byte_t* p_buf, const uint8_t* p_data, uint32_t count );
+uint32_t rb_spsc_read_B( Ring_Buffer_SPSC_Byte_t* p_buf, uint8_t* p_data, uint32_t count );
+
+/* contiguous access */
+uint32_t rb_spsc_read_span_F( Ring_Buffer_SPSC_Float_t* p_buf, const float** pp_data );
+void rb_spsc_consume_F( Ring_Buffer_SPSC_Float_t* p_buf, uint32_t count );
+uint32_t rb_spsc_write_span_F( Ring_Buffer_SPSC_Float_t* p_buf, float** pp_data );
+void rb_spsc_commit_F( Ring_Buffer_SPSC_Float_t* p_buf, uint32_t count );
+uint32_t rb_spsc_read_span_B( Ring_Buffer_SPSC_Byte_t* p_buf, const uint8_t** pp_data );
+void rb_spsc_consume_B( Ring_Buffer_SPSC_Byte_t* p_buf, uint32_t count );
+uint32_t rb_spsc_write_span_B( Ring_Buffer_SPSC_Byte_t* p_buf, uint8_t** pp_data );
+void rb_spsc_commit_B( Ring_Buffer_SPSC_Byte_t* p_buf, uint32_t count );
+
+#endif
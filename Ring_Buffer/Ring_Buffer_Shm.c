@@ -0,0 +1,161 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Ring_Buffer_Shm.h"
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+_Static_assert( ATOMIC_INT_LOCK_FREE == 2, "shared memory counters must be lock free to be shared between processes" );
+
+static size_t shm_size( uint32_t capacity )
+{
+    return offsetof( Ring_Buffer_Shm_Float_t, buffer ) + (size_t)capacity * sizeof( float );
+}
+
+/* Segment management */
+Ring_Buffer_Shm_Float_t* rb_shm_create_F( const char* name, uint32_t capacity )
+{
+    if( capacity == 0 || ( capacity & ( capacity - 1 ) ) != 0 )
+        return NULL;
+
+    int fd = shm_open( name, O_CREAT | O_EXCL | O_RDWR, 0600 );
+    if( fd < 0 )
+        return NULL;
+
+    void* p_map = MAP_FAILED;
+    if( ftruncate( fd, (off_t)shm_size( capacity ) ) == 0 )
+        p_map = mmap( NULL, shm_size( capacity ), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    close( fd );
+    if( p_map == MAP_FAILED ) {
+        shm_unlink( name );
+        return NULL;
+    }
+
+    Ring_Buffer_Shm_Float_t* p_buf = p_map;
+    p_buf->capacity                = capacity;
+    p_buf->mask                    = capacity - 1;
+    rb_spsc_index_initialize( &p_buf->index );
+
+    // last, so an opener that sees the magic also sees everything above
+    atomic_store_explicit( &p_buf->magic, RB_SHM_MAGIC, memory_order_release );
+    return p_buf;
+}
+
+Ring_Buffer_Shm_Float_t* rb_shm_open_F( const char* name )
+{
+    int fd = shm_open( name, O_RDWR, 0 );
+    if( fd < 0 )
+        return NULL;
+
+    // the creator may not have sized the segment yet
+    struct stat info;
+    if( fstat( fd, &info ) != 0 || (size_t)info.st_size < sizeof( Ring_Buffer_Shm_Float_t ) ) {
+        close( fd );
+        return NULL;
+    }
+
+    void* p_map = mmap( NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    close( fd );
+    if( p_map == MAP_FAILED )
+        return NULL;
+
+    // the indexing trusts capacity and mask, so check they describe this mapping before handing it out
+    Ring_Buffer_Shm_Float_t* p_buf = p_map;
+    bool valid                     = atomic_load_explicit( &p_buf->magic, memory_order_acquire ) == RB_SHM_MAGIC;
+    uint32_t capacity              = p_buf->capacity;
+    valid                          = valid && capacity != 0 && ( capacity & ( capacity - 1 ) ) == 0 && p_buf->mask == capacity - 1;
+    valid                          = valid && shm_size( capacity ) == (size_t)info.st_size;
+    if( !valid ) {
+        munmap( p_map, (size_t)info.st_size );
+        return NULL;
+    }
+
+    return p_buf;
+}
+
+void rb_shm_close_F( Ring_Buffer_Shm_Float_t* p_buf )
+{
+    munmap( p_buf, shm_size( p_buf->capacity ) );
+}
+
+int rb_shm_unlink_F( const char* name )
+{
+    return shm_unlink( name );
+}
+
+/* Return active Length of Buffer */
+uint32_t rb_shm_length_F( Ring_Buffer_Shm_Float_t* p_buf )
+{
+    return rb_spsc_index_length( &p_buf->index );
+}
+
+/* contiguous access */
+uint32_t rb_shm_read_span_F( Ring_Buffer_Shm_Float_t* p_buf, const float** pp_data )
+{
+    uint32_t slot;
+    uint32_t span = rb_spsc_index_read_span( &p_buf->index, p_buf->capacity, &slot );
+
+    *pp_data = &p_buf->buffer[slot];
+    return span;
+}
+
+void rb_shm_consume_F( Ring_Buffer_Shm_Float_t* p_buf, uint32_t count )
+{
+    rb_spsc_index_consume( &p_buf->index, count );
+}
+
+uint32_t rb_shm_write_span_F( Ring_Buffer_Shm_Float_t* p_buf, float** pp_data )
+{
+    uint32_t slot;
+    uint32_t span = rb_spsc_index_write_span( &p_buf->index, p_buf->capacity, &slot );
+
+    *pp_data = &p_buf->buffer[slot];
+    return span;
+}
+
+void rb_shm_commit_F( Ring_Buffer_Shm_Float_t* p_buf, uint32_t count )
+{
+    rb_spsc_index_commit( &p_buf->index, count );
+}
+
+/* Bulk access */
+uint32_t rb_shm_write_F( Ring_Buffer_Shm_Float_t* p_buf, const float* p_data, uint32_t count )
+{
+    return rb_spsc_index_write( &p_buf->index, p_buf->capacity, p_buf->buffer, sizeof( float ), p_data, count );
+}
+
+uint32_t rb_shm_read_F( Ring_Buffer_Shm_Float_t* p_buf, float* p_data, uint32_t count )
+{
+    return rb_spsc_index_read( &p_buf->index, p_buf->capacity, p_buf->buffer, sizeof( float ), p_data, count );
+}
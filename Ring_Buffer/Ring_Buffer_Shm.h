@@ -0,0 +1,105 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/* Ring_Buffer_Shm.h
+ *
+ * A single producer single consumer float ring buffer that lives in a POSIX shared memory segment, so a producer
+ * process and a consumer process can exchange samples without a pipe. The consumer reads the samples in place
+ * through rb_shm_read_span_F, so there is no copy in the kernel and no system call per batch.
+ *
+ * The counters and caching are the Rb_SPSC_Index_t of Ring_Buffer_SPSC, through the same rb_spsc_index_* helpers.
+ * The differences are:
+ *  - the layout has no pointers, only indices into buffer[], so each process may map it at a different address.
+ *  - the capacity is chosen when the segment is created and stored in the segment with its mask.
+ *  - a magic word is written last, with release ordering, when the creator has finished initializing. rb_shm_open_F
+ *    returns NULL until then, so a consumer started first just retries.
+ *  - rb_shm_open_F also returns NULL if the stored capacity is not a power of 2, the mask does not match it, or the
+ *    segment is not exactly the size that capacity needs, so a corrupt header cannot index outside the mapping.
+ *
+ * The producer creates the segment with rb_shm_create_F and the consumer attaches with rb_shm_open_F. Both unmap
+ * with rb_shm_close_F and one of them removes the name with rb_shm_unlink_F.
+ *
+ * Functions implemented are as follows:
+ *
+ * rb_shm_create_F      <-- Creates, sizes and initializes a named segment, returns the mapped ring
+ * rb_shm_open_F        <-- Maps an existing, initialized segment
+ * rb_shm_close_F       <-- Unmaps the ring from this process
+ * rb_shm_unlink_F      <-- Removes the segment name
+ * rb_shm_length_F      <-- Returns the number of active elements
+ * rb_shm_write_F       <-- Producer: appends as many elements of an array as fit
+ * rb_shm_read_F        <-- Consumer: removes up to count elements into an array
+ * rb_shm_read_span_F   <-- Consumer: contiguous run of active elements, released with rb_shm_consume_F
+ * rb_shm_write_span_F  <-- Producer: contiguous run of free space, published with rb_shm_commit_F
+ *
+ * Requires C11 atomics that are lock free, and POSIX shared memory, so this is not built for AVR_MCU.
+ * */
+#ifndef RING_BUFFER_SHM_H
+#define RING_BUFFER_SHM_H
+
+#include "Ring_Buffer_SPSC.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RB_SHM_CACHE_LINE 64
+#define RB_SHM_MAGIC      0x52425346u  // "RBSF"
+
+// data structure for a shared memory float ring buffer, always accessed through the mapping
+typedef struct {
+    _Atomic uint32_t magic;  // RB_SHM_MAGIC once initialized
+    uint32_t capacity;       // power of 2
+    uint32_t mask;
+
+    Rb_SPSC_Index_t index;
+
+    _Alignas( RB_SHM_CACHE_LINE ) float buffer[];
+} Ring_Buffer_Shm_Float_t;
+
+/* Segment management, capacity must be a power of 2. Return NULL on failure */
+Ring_Buffer_Shm_Float_t* rb_shm_create_F( const char* name, uint32_t capacity );
+Ring_Buffer_Shm_Float_t* rb_shm_open_F( const char* name );
+void rb_shm_close_F( Ring_Buffer_Shm_Float_t* p_buf );
+int rb_shm_unlink_F( const char* name );
+
+/* Return active Length of Buffer */
+uint32_t rb_shm_length_F( Ring_Buffer_Shm_Float_t* p_buf );
+
+/* Bulk access, returning the number of elements moved */
+uint32_t rb_shm_write_F( Ring_Buffer_Shm_Float_t* p_buf, const float* p_data, uint32_t count );
+uint32_t rb_shm_read_F( Ring_Buffer_Shm_Float_t* p_buf, float* p_data, uint32_t count );
+
+/* contiguous access */
+uint32_t rb_shm_read_span_F( Ring_Buffer_Shm_Float_t* p_buf, const float** pp_data );
+void rb_shm_consume_F( Ring_Buffer_Shm_Float_t* p_buf, uint32_t count );
+uint32_t rb_shm_write_span_F( Ring_Buffer_Shm_Float_t* p_buf, float** pp_data );
+void rb_shm_commit_F( Ring_Buffer_Shm_Float_t* p_buf, uint32_t count );
+
+#endif
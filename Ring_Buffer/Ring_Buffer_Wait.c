@@ -0,0 +1,199 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Ring_Buffer_Wait.h"
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint32_t wait_length( const Rb_Wait_t* p_wait )
+{
+    return ( p_wait->p_byte != NULL ) ? rb_spsc_length_B( p_wait->p_byte ) : rb_spsc_length_F( p_wait->p_float );
+}
+
+static void stat_increment( _Atomic uint64_t* p_counter )
+{
+    atomic_fetch_add_explicit( p_counter, 1, memory_order_relaxed );
+}
+
+static void futex_wake( _Atomic uint32_t* p_word )
+{
+    syscall( SYS_futex, p_word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0 );
+}
+
+// Sleeps while *p_word == expected. Returns false once the deadline has passed.
+static bool futex_wait( _Atomic uint32_t* p_word, uint32_t expected, const struct timespec* p_deadline )
+{
+    struct timespec remaining;
+    struct timespec* p_timeout = NULL;
+
+    if( p_deadline != NULL ) {
+        struct timespec now;
+        clock_gettime( CLOCK_MONOTONIC, &now );
+        remaining.tv_sec  = p_deadline->tv_sec - now.tv_sec;
+        remaining.tv_nsec = p_deadline->tv_nsec - now.tv_nsec;
+        if( remaining.tv_nsec < 0 ) {
+            remaining.tv_sec--;
+            remaining.tv_nsec += 1000000000;
+        }
+        if( remaining.tv_sec < 0 )
+            return false;
+        p_timeout = &remaining;
+    }
+
+    if( syscall( SYS_futex, p_word, FUTEX_WAIT_PRIVATE, expected, p_timeout, NULL, 0 ) < 0 && errno == ETIMEDOUT )
+        return false;
+
+    return true;
+}
+
+static void wait_initialize( Rb_Wait_t* p_wait )
+{
+    atomic_init( &p_wait->futex, 0 );
+    atomic_init( &p_wait->watermark, 0 );
+    atomic_init( &p_wait->notifies, 0 );
+    atomic_init( &p_wait->wakeups, 0 );
+    atomic_init( &p_wait->sleeps, 0 );
+    atomic_init( &p_wait->timeouts, 0 );
+}
+
+/* Initialization */
+void rb_wait_initialize_B( Rb_Wait_t* p_wait, Ring_Buffer_SPSC_Byte_t* p_buf )
+{
+    p_wait->p_byte  = p_buf;
+    p_wait->p_float = NULL;
+    wait_initialize( p_wait );
+}
+
+void rb_wait_initialize_F( Rb_Wait_t* p_wait, Ring_Buffer_SPSC_Float_t* p_buf )
+{
+    p_wait->p_byte  = NULL;
+    p_wait->p_float = p_buf;
+    wait_initialize( p_wait );
+}
+
+/* Producer */
+void rb_wait_notify( Rb_Wait_t* p_wait )
+{
+    stat_increment( &p_wait->notifies );
+
+    // pairs with the fence in rb_wait_for: either we see the consumer's watermark or it sees our data
+    atomic_thread_fence( memory_order_seq_cst );
+    uint32_t watermark = atomic_load_explicit( &p_wait->watermark, memory_order_relaxed );
+    if( watermark == 0 || wait_length( p_wait ) < watermark )
+        return;
+
+    rb_wait_wake( p_wait );
+}
+
+void rb_wait_wake( Rb_Wait_t* p_wait )
+{
+    // clearing the watermark first keeps further notifies from making redundant system calls
+    atomic_store( &p_wait->watermark, 0 );
+    atomic_fetch_add( &p_wait->futex, 1 );
+    futex_wake( &p_wait->futex );
+    stat_increment( &p_wait->wakeups );
+}
+
+bool rb_wait_push_back_B( Rb_Wait_t* p_wait, uint8_t value )
+{
+    if( !rb_spsc_push_back_B( p_wait->p_byte, value ) )
+        return false;
+
+    rb_wait_notify( p_wait );
+    return true;
+}
+
+bool rb_wait_push_back_F( Rb_Wait_t* p_wait, float value )
+{
+    if( !rb_spsc_push_back_F( p_wait->p_float, value ) )
+        return false;
+
+    rb_wait_notify( p_wait );
+    return true;
+}
+
+/* Consumer */
+uint32_t rb_wait_for( Rb_Wait_t* p_wait, uint32_t count, int timeout_ms )
+{
+    struct timespec deadline;
+    struct timespec* p_deadline = NULL;
+
+    // a full ring holds RB_LENGTH_SPSC elements, so a larger watermark would never be reached
+    if( count > RB_LENGTH_SPSC )
+        count = RB_LENGTH_SPSC;
+
+    if( timeout_ms >= 0 ) {
+        clock_gettime( CLOCK_MONOTONIC, &deadline );
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += ( timeout_ms % 1000 ) * 1000000L;
+        if( deadline.tv_nsec >= 1000000000 ) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        p_deadline = &deadline;
+    }
+
+    for( ;; ) {
+        uint32_t length = wait_length( p_wait );
+        if( length >= count || count == 0 )
+            return length;
+
+        // publish the watermark, then re-check the ring before sleeping so a push in between is not missed
+        uint32_t seen = atomic_load( &p_wait->futex );
+        atomic_store_explicit( &p_wait->watermark, count, memory_order_relaxed );
+        atomic_thread_fence( memory_order_seq_cst );
+
+        length = wait_length( p_wait );
+        if( length >= count ) {
+            atomic_store( &p_wait->watermark, 0 );
+            return length;
+        }
+
+        stat_increment( &p_wait->sleeps );
+        if( !futex_wait( &p_wait->futex, seen, p_deadline ) ) {
+            atomic_store( &p_wait->watermark, 0 );
+            stat_increment( &p_wait->timeouts );
+            return wait_length( p_wait );
+        }
+    }
+}
+
+/* Statistics */
+void rb_wait_get_stats( const Rb_Wait_t* p_wait, Rb_Wait_Stats_t* p_stats )
+{
+    p_stats->notifies = atomic_load_explicit( &p_wait->notifies, memory_order_relaxed );
+    p_stats->wakeups  = atomic_load_explicit( &p_wait->wakeups, memory_order_relaxed );
+    p_stats->sleeps   = atomic_load_explicit( &p_wait->sleeps, memory_order_relaxed );
+    p_stats->timeouts = atomic_load_explicit( &p_wait->timeouts, memory_order_relaxed );
+}
@@ -0,0 +1,105 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+/* Ring_Buffer_Wait.h
+ *
+ * Lets the consumer of a Ring_Buffer_SPSC_Byte_t or Ring_Buffer_SPSC_Float_t sleep until enough data has arrived
+ * instead of polling rb_spsc_length_X in a loop.
+ *
+ * The consumer calls rb_wait_for with the number of elements it wants (its watermark) and a timeout. The producer
+ * pushes through rb_wait_push_back_X, or pushes by any other means and then calls rb_wait_notify. A notify costs an
+ * atomic load unless a consumer is asleep and the watermark has been reached, and only then makes the futex system
+ * call, so a consumer asking for 64 bytes is woken once per 64 bytes rather than once per byte. rb_wait_wake wakes
+ * the consumer regardless of the watermark, e.g. at end of stream.
+ *
+ * One producer thread and one consumer thread per ring. The SPSC ring's acquire/release counters order the data
+ * against the length the consumer sees, and a push into a full ring fails rather than overwriting. Asking for more
+ * than RB_LENGTH_SPSC elements is clamped to RB_LENGTH_SPSC, since a larger count could never be satisfied. The
+ * statistics are atomic counters and can be read from any thread.
+ *
+ * Functions implemented are as follows:
+ *
+ * rb_wait_initialize_B/F  <-- Attaches a waiter to a ring
+ * rb_wait_push_back_B/F   <-- Producer: appends an element and notifies, false if the ring is full
+ * rb_wait_notify          <-- Producer: wakes the consumer if its watermark has been reached
+ * rb_wait_wake            <-- Producer: wakes the consumer unconditionally
+ * rb_wait_for             <-- Consumer: blocks until count elements are available or the timeout expires
+ * rb_wait_get_stats       <-- Notify, wakeup, sleep and timeout counts for tuning the watermark
+ *
+ * Linux only; not built for AVR_MCU.
+ * */
+#ifndef RING_BUFFER_WAIT_H
+#define RING_BUFFER_WAIT_H
+
+#include "Ring_Buffer_SPSC.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint64_t notifies;  // producer notify calls
+    uint64_t wakeups;   // notifies that woke the consumer
+    uint64_t sleeps;    // times the consumer blocked
+    uint64_t timeouts;  // waits that returned on timeout
+} Rb_Wait_Stats_t;
+
+// waiter attached to one ring, which is either a byte or a float ring
+typedef struct {
+    Ring_Buffer_SPSC_Byte_t* p_byte;
+    Ring_Buffer_SPSC_Float_t* p_float;
+    _Atomic uint32_t futex;      // bumped on every wake, the consumer sleeps on it
+    _Atomic uint32_t watermark;  // elements the sleeping consumer wants, 0 when it is not sleeping
+
+    // updated from both threads, see Rb_Wait_Stats_t
+    _Atomic uint64_t notifies;
+    _Atomic uint64_t wakeups;
+    _Atomic uint64_t sleeps;
+    _Atomic uint64_t timeouts;
+} Rb_Wait_t;
+
+/* Initialization */
+void rb_wait_initialize_B( Rb_Wait_t* p_wait, Ring_Buffer_SPSC_Byte_t* p_buf );
+void rb_wait_initialize_F( Rb_Wait_t* p_wait, Ring_Buffer_SPSC_Float_t* p_buf );
+
+/* Producer */
+bool rb_wait_push_back_B( Rb_Wait_t* p_wait, uint8_t value );
+bool rb_wait_push_back_F( Rb_Wait_t* p_wait, float value );
+void rb_wait_notify( Rb_Wait_t* p_wait );
+void rb_wait_wake( Rb_Wait_t* p_wait );
+
+/* Consumer, returns the number of elements available, which is less than count on timeout.
+   A negative timeout_ms waits forever. count is clamped to RB_LENGTH_SPSC. */
+uint32_t rb_wait_for( Rb_Wait_t* p_wait, uint32_t count, int timeout_ms );
+
+/* Statistics */
+void rb_wait_get_stats( const Rb_Wait_t* p_wait, Rb_Wait_Stats_t* p_stats );
+
+#endif
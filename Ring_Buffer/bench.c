@@ -0,0 +1,811 @@
+/*
+         MEGN540 Mechatronics Lab
+    Copyright (C) Andrew Petruska, 2023.
+       apetruska [at] mines [dot] edu
+          www.mechanical.mines.edu
+*/
+
+/*
+    Copyright (c) 2023 Andrew Petruska at Colorado School of Mines
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "Ring_Buffer.h"
+#include "Ring_Buffer_CRC.h"
+#include "Ring_Buffer_Delta.h"
+#include "Ring_Buffer_Event.h"
+#include "Ring_Buffer_Frame.h"
+#include "Ring_Buffer_Ingest.h"
+#include "Ring_Buffer_MPSC.h"
+#include "Ring_Buffer_Recorder.h"
+#include "Ring_Buffer_Shm.h"
+#include "Ring_Buffer_Wait.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_SAMPLES 4000000
+#define BENCH_BATCH   32
+
+static double now_s( void )
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/* Multi-producer comparison: mutex wrapped Ring_Buffer_Float_t vs the lock-free shared and sharded queues */
+
+typedef enum { MP_MUTEX, MP_SHARED_SINGLE, MP_SHARED_BULK, MP_SHARDED_BULK } Mp_Mode_t;
+
+static const char* mp_names[] = { "mutex Ring_Buffer_Float_t", "mpsc push_back", "mpsc write x32", "sharded write x32" };
+
+static Mp_Mode_t mp_mode;
+static uint32_t mp_per_producer;
+static pthread_mutex_t mp_lock = PTHREAD_MUTEX_INITIALIZER;
+static Ring_Buffer_Float_t mp_ring;
+static Ring_Buffer_MPSC_Float_t mp_shared;
+static Ring_Buffer_Sharded_Float_t mp_sharded;
+
+static void* mp_producer( void* p_arg )
+{
+    (void)p_arg;
+    float batch[BENCH_BATCH];
+    int lane = ( mp_mode == MP_SHARDED_BULK ) ? rb_sharded_add_lane_F( &mp_sharded ) : 0;
+
+    for( uint32_t i = 0; i < mp_per_producer; ) {
+        uint32_t moved = 0;
+        switch( mp_mode ) {
+            case MP_MUTEX:
+                // a plain ring overwrites when full, so only push while there is room
+                pthread_mutex_lock( &mp_lock );
+                if( rb_length_F( &mp_ring ) < RB_LENGTH_F - 1 ) {
+                    rb_push_back_F( &mp_ring, i );
+                    moved = 1;
+                }
+                pthread_mutex_unlock( &mp_lock );
+                break;
+            case MP_SHARED_SINGLE: moved = rb_mpsc_push_back_F( &mp_shared, i ); break;
+            case MP_SHARED_BULK:
+            case MP_SHARDED_BULK: {
+                uint32_t count = mp_per_producer - i;
+                if( count > BENCH_BATCH )
+                    count = BENCH_BATCH;
+                for( uint32_t k = 0; k < count; k++ )
+                    batch[k] = i + k;
+                moved = ( mp_mode == MP_SHARED_BULK ) ? rb_mpsc_write_F( &mp_shared, batch, count ) : rb_sharded_write_F( &mp_sharded, lane, batch, count );
+                break;
+            }
+        }
+        if( moved == 0 )
+            sched_yield();
+        i += moved;
+    }
+
+    return NULL;
+}
+
+static double mp_run( Mp_Mode_t mode, int producers )
+{
+    pthread_t threads[16];
+    float drain[256];
+    uint32_t total = 0;
+
+    mp_mode         = mode;
+    mp_per_producer = BENCH_SAMPLES / producers;
+    rb_initialize_F( &mp_ring );
+    rb_mpsc_initialize_F( &mp_shared );
+    rb_sharded_initialize_F( &mp_sharded );
+
+    double start = now_s();
+    for( int p = 0; p < producers; p++ )
+        pthread_create( &threads[p], NULL, mp_producer, NULL );
+
+    // the calling thread is the consumer
+    while( total < mp_per_producer * producers ) {
+        uint32_t got = 0;
+        switch( mode ) {
+            case MP_MUTEX:
+                pthread_mutex_lock( &mp_lock );
+                while( rb_length_F( &mp_ring ) > 0 && got < 256 )
+                    drain[got++] = rb_pop_front_F( &mp_ring );
+                pthread_mutex_unlock( &mp_lock );
+                break;
+            case MP_SHARED_SINGLE:
+            case MP_SHARED_BULK: got = rb_mpsc_read_F( &mp_shared, drain, 256 ); break;
+            case MP_SHARDED_BULK: got = rb_sharded_read_F( &mp_sharded, drain, 256 ); break;
+        }
+        if( got == 0 )
+            sched_yield();
+        total += got;
+    }
+
+    for( int p = 0; p < producers; p++ )
+        pthread_join( threads[p], NULL );
+
+    return total / ( now_s() - start ) * 1e-6;
+}
+
+/* Blocking consumer: wakeups issued for each watermark the consumer waits on */
+
+#define WAIT_SAMPLES 1000000
+
+static Ring_Buffer_SPSC_Byte_t wait_ring;
+static Rb_Wait_t wait_waiter;
+
+static void* wait_producer( void* p_arg )
+{
+    (void)p_arg;
+    for( uint32_t i = 0; i < WAIT_SAMPLES; i++ ) {
+        while( !rb_wait_push_back_B( &wait_waiter, (uint8_t)i ) )
+            sched_yield();
+    }
+    rb_wait_wake( &wait_waiter );
+    return NULL;
+}
+
+static void wait_run( uint32_t watermark )
+{
+    static uint8_t drained[RB_LENGTH_SPSC];
+    pthread_t producer;
+    uint32_t total = 0;
+    Rb_Wait_Stats_t stats;
+
+    rb_spsc_initialize_B( &wait_ring );
+    rb_wait_initialize_B( &wait_waiter, &wait_ring );
+
+    double start = now_s();
+    pthread_create( &producer, NULL, wait_producer, NULL );
+    while( total < WAIT_SAMPLES ) {
+        uint32_t got = rb_wait_for( &wait_waiter, watermark, 10 );
+        total += rb_spsc_read_B( &wait_ring, drained, got );
+    }
+    double elapsed = now_s() - start;
+    pthread_join( producer, NULL );
+
+    rb_wait_get_stats( &wait_waiter, &stats );
+    printf( "%-12u%12.2f%12llu%12llu%12llu\n", watermark, total / elapsed * 1e-6, (unsigned long long)stats.wakeups,
+            (unsigned long long)stats.sleeps, (unsigned long long)stats.timeouts );
+}
+
+/* Event loop consumer: time from the push that crosses the threshold until epoll_wait returns */
+
+#define EVENT_ROUNDS 20000
+
+static Ring_Buffer_SPSC_Float_t event_ring;
+static Rb_Event_t event_signal;
+static _Atomic uint32_t event_done;
+static double event_pushed_at[EVENT_ROUNDS];
+
+static void* event_producer( void* p_arg )
+{
+    uint32_t threshold = *(uint32_t*)p_arg;
+    for( uint32_t r = 0; r < EVENT_ROUNDS; r++ ) {
+        for( uint32_t i = 0; i + 1 < threshold; i++ )
+            rb_event_push_back_F( &event_signal, (float)i );
+        event_pushed_at[r] = now_s();
+        rb_event_push_back_F( &event_signal, 0.0f );
+
+        // one round in flight at a time so each latency is measured from an idle consumer
+        while( atomic_load( &event_done ) <= r )
+            sched_yield();
+    }
+    return NULL;
+}
+
+static int compare_double( const void* p_a, const void* p_b )
+{
+    double a = *(const double*)p_a, b = *(const double*)p_b;
+    return ( a > b ) - ( a < b );
+}
+
+static void event_run( uint32_t threshold )
+{
+    static double latency[EVENT_ROUNDS];
+    pthread_t producer;
+    struct epoll_event ev;
+
+    rb_spsc_initialize_F( &event_ring );
+    atomic_store( &event_done, 0 );
+    int fd   = rb_event_initialize_F( &event_signal, &event_ring, threshold );
+    int epfd = epoll_create1( 0 );
+    ev       = (struct epoll_event){ .events = EPOLLIN, .data.fd = fd };
+    epoll_ctl( epfd, EPOLL_CTL_ADD, fd, &ev );
+
+    pthread_create( &producer, NULL, event_producer, &threshold );
+    for( uint32_t r = 0; r < EVENT_ROUNDS; r++ ) {
+        while( epoll_wait( epfd, &ev, 1, -1 ) != 1 )
+            ;
+        latency[r] = ( now_s() - event_pushed_at[r] ) * 1e6;
+        float value;
+        while( rb_spsc_pop_front_F( &event_ring, &value ) )
+            ;
+        rb_event_ack( &event_signal );
+        atomic_store( &event_done, r + 1 );
+    }
+    pthread_join( producer, NULL );
+
+    qsort( latency, EVENT_ROUNDS, sizeof( double ), compare_double );
+    printf( "%-12u%12.2f%12.2f%12.2f%12llu\n", threshold, latency[EVENT_ROUNDS / 2], latency[EVENT_ROUNDS * 99 / 100],
+            latency[EVENT_ROUNDS - 1], (unsigned long long)atomic_load( &event_signal.signals ) );
+
+    close( epfd );
+    rb_event_close( &event_signal );
+}
+
+/* Two processes: samples through a shared memory ring read in place, vs. through a pipe */
+
+#define SHM_SAMPLES  16000000  // the samples count up in float, exact below 2^24
+#define SHM_BATCH    1024
+#define SHM_CAPACITY 16384
+#define SHM_NAME     "/ringbuffer_bench"
+
+// consumer process, checks every sample so the comparison includes touching the data
+static int shm_consume( int pipe_fd )
+{
+    float expected = 0.0f;
+    uint32_t total = 0;
+
+    if( pipe_fd < 0 ) {
+        Ring_Buffer_Shm_Float_t* p_ring;
+        while( ( p_ring = rb_shm_open_F( SHM_NAME ) ) == NULL )
+            sched_yield();
+
+        while( total < SHM_SAMPLES ) {
+            const float* p_data;
+            uint32_t span = rb_shm_read_span_F( p_ring, &p_data );
+            if( span == 0 ) {
+                sched_yield();
+                continue;
+            }
+            for( uint32_t i = 0; i < span; i++, expected += 1.0f )
+                if( p_data[i] != expected )
+                    return 1;
+            rb_shm_consume_F( p_ring, span );
+            total += span;
+        }
+        rb_shm_close_F( p_ring );
+    } else {
+        float batch[SHM_BATCH];
+        while( total < SHM_SAMPLES ) {
+            ssize_t got = read( pipe_fd, batch, sizeof( batch ) );
+            if( got <= 0 || got % sizeof( float ) != 0 )
+                return 1;  // a partial float would need reassembly, which a pipe of this size never produces
+            for( ssize_t i = 0; i < got / (ssize_t)sizeof( float ); i++, expected += 1.0f )
+                if( batch[i] != expected )
+                    return 1;
+            total += got / sizeof( float );
+        }
+    }
+
+    return 0;
+}
+
+static double shm_run( bool use_pipe )
+{
+    float batch[SHM_BATCH];
+    float next = 0.0f;
+    int fds[2] = { -1, -1 };
+    Ring_Buffer_Shm_Float_t* p_ring = NULL;
+
+    if( use_pipe ) {
+        if( pipe( fds ) != 0 )
+            return 0.0;
+    } else {
+        rb_shm_unlink_F( SHM_NAME );
+        if( ( p_ring = rb_shm_create_F( SHM_NAME, SHM_CAPACITY ) ) == NULL )
+            return 0.0;
+    }
+
+    double start = now_s();
+    pid_t child  = fork();
+    if( child == 0 ) {
+        if( use_pipe )
+            close( fds[1] );
+        _exit( shm_consume( fds[0] ) );
+    }
+
+    for( uint32_t sent = 0; sent < SHM_SAMPLES; sent += SHM_BATCH ) {
+        for( int i = 0; i < SHM_BATCH; i++, next += 1.0f )
+            batch[i] = next;
+
+        if( use_pipe ) {
+            if( write( fds[1], batch, sizeof( batch ) ) != sizeof( batch ) )
+                break;
+        } else {
+            uint32_t written = 0;
+            while( ( written += rb_shm_write_F( p_ring, batch + written, SHM_BATCH - written ) ) < SHM_BATCH )
+                sched_yield();
+        }
+    }
+
+    int status;
+    waitpid( child, &status, 0 );
+    double elapsed = now_s() - start;
+
+    if( use_pipe ) {
+        close( fds[0] );
+        close( fds[1] );
+    } else {
+        rb_shm_close_F( p_ring );
+        rb_shm_unlink_F( SHM_NAME );
+    }
+
+    return ( WIFEXITED( status ) && WEXITSTATUS( status ) == 0 ) ? SHM_SAMPLES / elapsed * 1e-6 : 0.0;
+}
+
+/* File through a byte ring to /dev/null: readv/writev on the ring storage vs. staging arrays and single element access */
+
+#define FD_FILE_BYTES ( 64u << 20 )
+#define FD_FILE_NAME  "/tmp/ringbuffer_bench.dat"
+
+static double fd_run( bool use_fd )
+{
+    uint8_t staging[RB_LENGTH_B];
+    Ring_Buffer_Byte_t ring;
+    uint64_t total = 0;
+
+    int in  = open( FD_FILE_NAME, O_RDONLY );
+    int out = open( "/dev/null", O_WRONLY );
+    if( in < 0 || out < 0 )
+        return 0.0;
+
+    rb_initialize_B( &ring );
+    double start = now_s();
+    for( ;; ) {
+        int got;
+        if( use_fd ) {
+            got = rb_read_fd_B( &ring, in );
+            rb_write_fd_B( &ring, out );
+        } else {
+            got = read( in, staging, RB_LENGTH_B - 1 - rb_length_B( &ring ) );
+            for( int i = 0; i < got; i++ )
+                rb_push_back_B( &ring, staging[i] );
+
+            int length = rb_length_B( &ring );
+            for( int i = 0; i < length; i++ )
+                staging[i] = rb_pop_front_B( &ring );
+            (void)!write( out, staging, length );
+        }
+        if( got <= 0 )
+            break;
+        total += got;
+    }
+    double elapsed = now_s() - start;
+
+    close( in );
+    close( out );
+    return ( total == FD_FILE_BYTES ) ? total / elapsed * 1e-6 : 0.0;
+}
+
+/* Many pipes into one ring each from a single thread: io_uring vs. epoll + readv */
+
+#define INGEST_SOURCES 16
+#define INGEST_BYTES   ( 4u << 20 )  // per source
+#define INGEST_CHUNK   1000
+
+static int ingest_pipes[INGEST_SOURCES][2];
+
+// writes every pipe round robin in chunks, like a set of devices producing at the same rate
+static void* ingest_writer( void* p_arg )
+{
+    (void)p_arg;
+    uint8_t chunk[INGEST_CHUNK];
+    for( uint32_t i = 0; i < INGEST_CHUNK; i++ )
+        chunk[i] = (uint8_t)i;
+
+    for( uint32_t sent = 0; sent < INGEST_BYTES; sent += INGEST_CHUNK )
+        for( int s = 0; s < INGEST_SOURCES; s++ )
+            (void)!write( ingest_pipes[s][1], chunk, ( INGEST_BYTES - sent < INGEST_CHUNK ) ? INGEST_BYTES - sent : INGEST_CHUNK );
+
+    for( int s = 0; s < INGEST_SOURCES; s++ )
+        close( ingest_pipes[s][1] );
+    return NULL;
+}
+
+static void ingest_run( bool allow_uring )
+{
+    static Ring_Buffer_Byte_t rings[INGEST_SOURCES];
+    Rb_Ingest_t ingest;
+    pthread_t writer;
+    uint64_t total = 0;
+
+    if( !rb_ingest_initialize( &ingest, allow_uring ) )
+        return;
+    for( int s = 0; s < INGEST_SOURCES; s++ ) {
+        if( pipe( ingest_pipes[s] ) != 0 )
+            return;
+        rb_initialize_B( &rings[s] );
+        rb_ingest_add( &ingest, ingest_pipes[s][0], &rings[s] );
+    }
+
+    double start = now_s();
+    pthread_create( &writer, NULL, ingest_writer, NULL );
+    for( int open_sources = INGEST_SOURCES; open_sources > 0; ) {
+        if( rb_ingest_poll( &ingest, 100 ) < 0 )
+            break;
+
+        open_sources = 0;
+        for( int s = 0; s < INGEST_SOURCES; s++ ) {
+            const uint8_t* p_data;
+            uint8_t span;
+            while( ( span = rb_read_span_B( &rings[s], &p_data ) ) > 0 ) {
+                rb_consume_B( &rings[s], span );
+                total += span;
+            }
+            open_sources += !ingest.sources[s].closed;
+        }
+    }
+    double elapsed = now_s() - start;
+    pthread_join( writer, NULL );
+
+    printf( "%-28s%10.2f%16.2f\n", ( ingest.backend == RB_INGEST_URING ) ? "io_uring" : "epoll + readv", total / elapsed * 1e-6,
+            ingest.waits ? (double)ingest.completions / ingest.waits : 0.0 );
+
+    rb_ingest_close( &ingest );
+    for( int s = 0; s < INGEST_SOURCES; s++ )
+        close( ingest_pipes[s][0] );
+}
+
+/* Flight recorder: push cost against an in-memory ring, and what a post-mortem reader finds after a crash */
+
+#define RECORDER_SAMPLES  ( 1u << 26 )
+#define RECORDER_CAPACITY ( 1u << 16 )
+#define RECORDER_FILE     "/tmp/ringbuffer_bench.rec"
+
+static double recorder_push_rate( uint32_t sync_interval )
+{
+    Ring_Buffer_Recorder_Float_t recorder;
+    unlink( RECORDER_FILE );
+    if( !rb_recorder_open_F( &recorder, RECORDER_FILE, RECORDER_CAPACITY, sync_interval ) )
+        return 0.0;
+
+    double start = now_s();
+    for( uint32_t i = 0; i < RECORDER_SAMPLES; i++ )
+        rb_recorder_push_back_F( &recorder, (float)i );
+    double elapsed = now_s() - start;
+
+    rb_recorder_close_F( &recorder );
+    return RECORDER_SAMPLES / elapsed * 1e-6;
+}
+
+static void recorder_run( void )
+{
+    Ring_Buffer_Float_t ring;
+    rb_initialize_F( &ring );
+
+    double start = now_s();
+    for( uint32_t i = 0; i < RECORDER_SAMPLES; i++ )
+        rb_push_back_F( &ring, (float)i );
+    double elapsed = now_s() - start;
+
+    // keep the in-memory pushes from being optimized away
+    printf( "%-28s%10.2f  (last %.0f)\n", "rb_push_back_F", RECORDER_SAMPLES / elapsed * 1e-6, rb_get_F( &ring, rb_length_F( &ring ) - 1 ) );
+    printf( "%-28s%10.2f\n", "recorder, no msync", recorder_push_rate( 0 ) );
+    printf( "%-28s%10.2f\n", "recorder, msync every 2^20", recorder_push_rate( 1u << 20 ) );
+
+    // a child records and aborts part way, the parent reads what it left behind
+    unlink( RECORDER_FILE );
+    pid_t child = fork();
+    if( child == 0 ) {
+        Ring_Buffer_Recorder_Float_t recorder;
+        if( rb_recorder_open_F( &recorder, RECORDER_FILE, RECORDER_CAPACITY, 0 ) )
+            for( uint32_t i = 0; i < 1000000; i++ )
+                rb_recorder_push_back_F( &recorder, (float)i );
+        abort();
+    }
+    waitpid( child, NULL, 0 );
+
+    Ring_Buffer_Recorder_Float_t post_mortem;
+    if( rb_recorder_attach_F( &post_mortem, RECORDER_FILE ) ) {
+        uint32_t length = rb_recorder_length_F( &post_mortem );
+        printf( "after abort(): %u samples, oldest %.0f, newest %.0f\n", length, rb_recorder_get_F( &post_mortem, 0 ),
+                rb_recorder_get_F( &post_mortem, length - 1 ) );
+        rb_recorder_close_F( &post_mortem );
+    }
+    unlink( RECORDER_FILE );
+}
+
+/* Delta/varint compression of a slowly moving sensor signal through a float ring, a byte ring and back */
+
+#define DELTA_SAMPLES 4000000
+
+static void delta_run( float resolution, float step )
+{
+    Rb_Delta_t encoder, decoder;
+    Ring_Buffer_Float_t source, received;
+    Ring_Buffer_Byte_t link;
+    uint32_t seed = 12345, sent = 0, got = 0;
+    float value = 0.0f, max_error = 0.0f;
+    static float history[DELTA_SAMPLES];
+
+    rb_delta_initialize( &encoder, resolution );
+    rb_delta_initialize( &decoder, resolution );
+    rb_initialize_F( &source );
+    rb_initialize_F( &received );
+    rb_initialize_B( &link );
+
+    // a random walk of up to +-step per sample
+    for( uint32_t i = 0; i < DELTA_SAMPLES; i++ ) {
+        seed       = seed * 1664525u + 1013904223u;
+        value      += step * ( (int32_t)( seed >> 16 ) - 32768 ) / 32768.0f;
+        history[i] = value;
+    }
+
+    double start = now_s();
+    while( got < DELTA_SAMPLES ) {
+        while( sent < DELTA_SAMPLES && rb_length_F( &source ) < RB_LENGTH_F - 1 )
+            rb_push_back_F( &source, history[sent++] );
+        rb_delta_encode( &encoder, &source, &link );
+        rb_delta_decode( &decoder, &link, &received );
+
+        const float* p_data;
+        uint8_t span;
+        while( ( span = rb_read_span_F( &received, &p_data ) ) > 0 ) {
+            for( uint8_t i = 0; i < span; i++, got++ ) {
+                float error = p_data[i] - history[got];
+                max_error   = ( error > max_error ) ? error : ( -error > max_error ) ? -error : max_error;
+            }
+            rb_consume_F( &received, span );
+        }
+    }
+    double elapsed = now_s() - start;
+
+    printf( "%-12g%-12g%10.2f%14.2f%14g\n", resolution, step, rb_delta_ratio( &encoder ), DELTA_SAMPLES / elapsed * 1e-6, max_error );
+}
+
+/* Framing: 64 byte COBS and SLIP frames through a byte ring, vs. decoding COBS with rb_pop_front_B per byte */
+
+#define FRAME_COUNT  2000000
+#define FRAME_LENGTH 64
+
+// the per-byte decoder the ring framing replaces, returns the frame length or -1 when no frame is complete
+static int frame_pop_decode( Ring_Buffer_Byte_t* p_buf, uint8_t* p_out )
+{
+    uint8_t length = rb_length_B( p_buf ), end = 0;
+    while( end < length && rb_get_B( p_buf, end ) != 0 )
+        end++;
+    if( end == length )
+        return -1;
+
+    int out = 0;
+    while( rb_length_B( p_buf ) > 0 ) {
+        uint8_t code = rb_pop_front_B( p_buf );
+        if( code == 0 )
+            break;
+        for( uint8_t i = 1; i < code; i++ )
+            p_out[out++] = rb_pop_front_B( p_buf );
+        if( code != 0xFF && rb_get_B( p_buf, 0 ) != 0 )
+            p_out[out++] = 0;
+    }
+    return out;
+}
+
+static void frame_run( int mode )
+{
+    static const char* names[] = { "COBS, rb_pop_front_B", "COBS, rb_cobs_decode_B", "SLIP, rb_slip_decode_B" };
+    Ring_Buffer_Byte_t link;
+    uint8_t frame[FRAME_LENGTH], out[RB_LENGTH_B];
+    uint32_t seed = 1, received = 0, errors = 0;
+
+    // sensor-like payload, about one byte in 16 is a zero or a SLIP special
+    for( int i = 0; i < FRAME_LENGTH; i++ ) {
+        seed     = seed * 1664525u + 1013904223u;
+        frame[i] = ( ( seed >> 24 ) < 16 ) ? ( ( i & 1 ) ? 0xC0 : 0 ) : (uint8_t)( seed >> 16 );
+    }
+    rb_initialize_B( &link );
+
+    double start = now_s();
+    for( uint32_t sent = 0; sent < FRAME_COUNT; sent++ ) {
+        if( ( ( mode == 2 ) ? rb_slip_encode_B( &link, frame, FRAME_LENGTH ) : rb_cobs_encode_B( &link, frame, FRAME_LENGTH ) ) == 0 )
+            return;
+
+        int length = ( mode == 0 ) ? frame_pop_decode( &link, out )
+                     : ( mode == 1 ) ? rb_cobs_decode_B( &link, out, sizeof( out ) - 1 )
+                                     : rb_slip_decode_B( &link, out, sizeof( out ) - 1 );
+        received++;
+        errors += ( length != FRAME_LENGTH || memcmp( out, frame, FRAME_LENGTH ) != 0 );
+    }
+    double elapsed = now_s() - start;
+
+    printf( "%-28s%10.2f%10u\n", names[mode], received / elapsed * 1e-6, errors );
+}
+
+/* Search for a line end and a sync word near the end of a full, wrapped ring: rb_find_B/rb_find_seq_B vs. rb_get_B */
+
+#define FIND_ROUNDS 2000000
+
+static void find_run( void )
+{
+    static const uint8_t sync[] = { 0xA5, 0x5A };
+    Ring_Buffer_Byte_t ring;
+    int64_t checksum[2] = { 0, 0 };
+
+    // start part way through storage so the active region wraps, and put the targets at the end
+    rb_initialize_B( &ring );
+    for( int i = 0; i < RB_LENGTH_B / 2; i++ )
+        rb_push_back_B( &ring, 0 );
+    rb_consume_B( &ring, RB_LENGTH_B / 2 );
+    for( int i = 0; i < RB_LENGTH_B - 4; i++ )
+        rb_push_back_B( &ring, (uint8_t)( 'a' + i % 26 ) );
+    rb_push_back_B( &ring, sync[0] );
+    rb_push_back_B( &ring, sync[1] );
+    rb_push_back_B( &ring, '\n' );
+
+    double start = now_s();
+    for( uint32_t r = 0; r < FIND_ROUNDS; r++ ) {
+        uint8_t length = rb_length_B( &ring );
+        int index      = 0;
+        while( index < length && rb_get_B( &ring, index ) != '\n' )
+            index++;
+        checksum[0] += index;
+
+        index = 0;
+        while( index + 1 < length && !( rb_get_B( &ring, index ) == sync[0] && rb_get_B( &ring, index + 1 ) == sync[1] ) )
+            index++;
+        checksum[0] += index;
+    }
+    double get_s = now_s() - start;
+
+    start = now_s();
+    for( uint32_t r = 0; r < FIND_ROUNDS; r++ ) {
+        checksum[1] += rb_find_B( &ring, '\n' );
+        checksum[1] += rb_find_seq_B( &ring, sync, sizeof( sync ) );
+    }
+    double find_s = now_s() - start;
+
+    printf( "%-28s%10.2f\n", "rb_get_B loops", FIND_ROUNDS / get_s * 1e-6 );
+    printf( "%-28s%10.2f  (%s)\n", "rb_find_B + rb_find_seq_B", FIND_ROUNDS / find_s * 1e-6, ( checksum[0] == checksum[1] ) ? "same indices" : "DIFFERENT" );
+}
+
+/* CRCs of a full, wrapped ring: copy out and a byte at a time vs. rb_crc*_B over the two segments in place */
+
+#define CRC_ROUNDS 400000
+
+static void crc_run( void )
+{
+    static const char* names[] = { "CRC-16/MODBUS", "CRC-32", "CRC-32C" };
+    Ring_Buffer_Byte_t ring;
+    uint8_t copy[RB_LENGTH_B];
+
+    rb_initialize_B( &ring );
+    for( int i = 0; i < RB_LENGTH_B / 2; i++ )
+        rb_push_back_B( &ring, 0 );
+    rb_consume_B( &ring, RB_LENGTH_B / 2 );
+    srand( 50 );
+    for( int i = 0; i < RB_LENGTH_B - 1; i++ )
+        rb_push_back_B( &ring, (uint8_t)rand() );
+    uint8_t length = rb_length_B( &ring );
+
+    for( Rb_Crc_Kind_t kind = RB_CRC16_MODBUS; kind <= RB_CRC32C; kind++ ) {
+        uint32_t values[2] = { 0, 0 };
+
+        double start = now_s();
+        for( uint32_t r = 0; r < CRC_ROUNDS; r++ ) {
+            Rb_Crc_t crc;
+            rb_crc_initialize( &crc, kind );
+            for( uint8_t i = 0; i < length; i++ )
+                copy[i] = rb_get_B( &ring, i );
+            for( uint8_t i = 0; i < length; i++ )
+                rb_crc_update( &crc, &copy[i], 1 );
+            values[0] ^= rb_crc_value( &crc ) + r;
+        }
+        double bytewise_s = now_s() - start;
+
+        start = now_s();
+        for( uint32_t r = 0; r < CRC_ROUNDS; r++ ) {
+            uint32_t value = ( kind == RB_CRC16_MODBUS ) ? rb_crc16_B( &ring, 0, length )
+                             : ( kind == RB_CRC32 )      ? rb_crc32_B( &ring, 0, length )
+                                                         : rb_crc32c_B( &ring, 0, length );
+            values[1] ^= value + r;
+        }
+        double ring_s = now_s() - start;
+
+        double megabytes = (double)CRC_ROUNDS * length * 1e-6;
+        printf( "%-16s%12.1f%12.1f  (%s)\n", names[kind], megabytes / bytewise_s, megabytes / ring_s, ( values[0] == values[1] ) ? "same CRCs" : "DIFFERENT" );
+    }
+}
+
+int main()
+{
+    int producer_counts[] = { 1, 2, 4, 8, 16 };
+
+    printf( "Multi-producer queues, %i samples, Msamples/s (RB_LENGTH_F %i, RB_LENGTH_MPSC %i)\n", BENCH_SAMPLES, RB_LENGTH_F, RB_LENGTH_MPSC );
+    printf( "%-28s", "producers" );
+    for( int c = 0; c < 5; c++ )
+        printf( "%10i", producer_counts[c] );
+    printf( "\n" );
+
+    for( int m = MP_MUTEX; m <= MP_SHARDED_BULK; m++ ) {
+        printf( "%-28s", mp_names[m] );
+        for( int c = 0; c < 5; c++ ) {
+            printf( "%10.2f", mp_run( m, producer_counts[c] ) );
+            fflush( stdout );
+        }
+        printf( "\n" );
+    }
+
+    printf( "\nBlocking byte consumer, %i samples (RB_LENGTH_SPSC %i)\n", WAIT_SAMPLES, RB_LENGTH_SPSC );
+    printf( "%-12s%12s%12s%12s%12s\n", "watermark", "Msamples/s", "wakeups", "sleeps", "timeouts" );
+    uint32_t watermarks[] = { 1, 16, 64, 128 };
+    for( int w = 0; w < 4; w++ )
+        wait_run( watermarks[w] );
+
+    printf( "\neventfd + epoll wake latency, %i rounds, microseconds\n", EVENT_ROUNDS );
+    printf( "%-12s%12s%12s%12s%12s\n", "threshold", "p50", "p99", "max", "signals" );
+    uint32_t thresholds[] = { 1, 32 };
+    for( int t = 0; t < 2; t++ )
+        event_run( thresholds[t] );
+
+    printf( "\nTwo processes, %i samples in batches of %i, Msamples/s (0 means the consumer saw a wrong sample)\n", SHM_SAMPLES, SHM_BATCH );
+    printf( "%-28s%10.2f\n", "pipe", shm_run( true ) );
+    printf( "%-28s%10.2f\n", "shared memory ring", shm_run( false ) );
+
+    // cached file, so the comparison is system call and copy overhead rather than the disk
+    static uint8_t block[1 << 16];
+    int file = open( FD_FILE_NAME, O_WRONLY | O_CREAT | O_TRUNC, 0600 );
+    for( uint32_t i = 0; i < sizeof( block ); i++ )
+        block[i] = (uint8_t)( i * 31 );
+    for( uint32_t written = 0; file >= 0 && written < FD_FILE_BYTES; written += sizeof( block ) )
+        (void)!write( file, block, sizeof( block ) );
+    close( file );
+
+    printf( "\nFile to /dev/null through a byte ring, %u MB, MB/s (RB_LENGTH_B %i)\n", FD_FILE_BYTES >> 20, RB_LENGTH_B );
+    printf( "%-28s%10.2f\n", "read/push/pop/write", fd_run( false ) );
+    printf( "%-28s%10.2f\n", "rb_read_fd_B/rb_write_fd_B", fd_run( true ) );
+    unlink( FD_FILE_NAME );
+
+    printf( "\n%i pipes into byte rings from one thread, %u MB each (RB_LENGTH_B %i)\n", INGEST_SOURCES, INGEST_BYTES >> 20, RB_LENGTH_B );
+    printf( "%-28s%10s%16s\n", "backend", "MB/s", "reads per wait" );
+    ingest_run( true );
+    ingest_run( false );
+
+    printf( "\nFlight recorder, %u pushes, Msamples/s (capacity %u)\n", RECORDER_SAMPLES, RECORDER_CAPACITY );
+    recorder_run();
+
+    printf( "\nDelta/varint compression, %i samples, encode + decode\n", DELTA_SAMPLES );
+    printf( "%-12s%-12s%10s%14s%14s\n", "resolution", "max step", "ratio", "Msamples/s", "max error" );
+    delta_run( 0.01f, 0.5f );
+    delta_run( 0.01f, 2.0f );
+    delta_run( 0.001f, 2.0f );
+
+    printf( "\nFraming, %i frames of %i bytes, encode + decode (RB_LENGTH_B %i)\n", FRAME_COUNT, FRAME_LENGTH, RB_LENGTH_B );
+    printf( "%-28s%10s%10s\n", "", "Mframes/s", "errors" );
+    for( int mode = 0; mode < 3; mode++ )
+        frame_run( mode );
+
+    printf( "\nLine end and sync word search in a full wrapped ring, Msearches/s (RB_LENGTH_B %i)\n", RB_LENGTH_B );
+    find_run();
+
+    printf( "\nCRC of a full wrapped ring, MB/s (RB_LENGTH_B %i)\n", RB_LENGTH_B );
+    printf( "%-16s%12s%12s\n", "", "bytewise", "in place" );
+    crc_run();
+
+    return 0;
+}
@@ -28,10 +28,1023 @@
 
 */
 
+#include "Pool.h"
 #include "Ring_Buffer.h"
-
+#include "Ring_Buffer_Broadcast.h"
+#include "Ring_Buffer_CRC.h"
+#include "Ring_Buffer_Delta.h"
+#include "Ring_Buffer_Event.h"
+#include "Ring_Buffer_Frame.h"
+#include "Ring_Buffer_Ingest.h"
+#include "Ring_Buffer_MPSC.h"
+#include "Ring_Buffer_Mirror.h"
+#include "Ring_Buffer_Recorder.h"
+#include "Ring_Buffer_Shm.h"
+#include "Ring_Buffer_Wait.h"
+
+#include <errno.h>
+#include <fcntl.h>
 #include <math.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Checks of the modules built on the ring buffers. They report separately from the score above. */
+
+// xorshift32, so the randomized checks are repeatable
+static uint32_t check_random( void )
+{
+    static uint32_t state = 2463534242u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Pool: exhaustion, reuse, refused double frees and refused blocks smaller than a pointer
+static bool check_pool( void )
+{
+    POOL_STORAGE( blocks, Ring_Buffer_Byte_t, 4 );
+    Pool_t pool;
+    Pool_Stats_t stats;
+    void* p_block[5];
+    bool ok = true;
+
+    POOL_INIT( &pool, blocks );
+    for( int i = 0; i < 5; i++ )
+        p_block[i] = Pool_Alloc( &pool );
+    for( int i = 0; i < 4; i++ )
+        for( int j = 0; j < i; j++ )
+            ok &= p_block[i] != NULL && p_block[i] != p_block[j];
+    ok &= p_block[4] == NULL;
+
+    // the second free of block 1 and the misaligned free must both be ignored
+    Pool_Free( &pool, p_block[1] );
+    Pool_Free( &pool, p_block[1] );
+    Pool_Free( &pool, (uint8_t*)p_block[2] + 1 );
+    Pool_Get_Stats( &pool, &stats );
+    ok &= stats.in_use == 3 && stats.peak == 4 && stats.failed == 1;
+
+    void* p_first  = Pool_Alloc( &pool );
+    void* p_second = Pool_Alloc( &pool );
+    ok &= p_first == p_block[1] && p_second == NULL;
+
+    for( int i = 0; i < 4; i++ )
+        Pool_Free( &pool, p_block[i] );
+    Pool_Free( &pool, p_block[0] );
+    Pool_Get_Stats( &pool, &stats );
+    ok &= stats.in_use == 0;
+
+    for( int i = 0; i < UINT16_MAX + 10; i++ )
+        Pool_Alloc( &pool );
+    Pool_Get_Stats( &pool, &stats );
+    ok &= stats.failed == UINT16_MAX;
+
+    // blocks too small for the free-list link must be refused
+    static uint8_t small_blocks[4][sizeof( void* ) - 1], small_in_use[POOL_BITMAP_BYTES( 4 )];
+    ok &= !Pool_Init( &pool, small_blocks, sizeof( small_blocks[0] ), 4, small_in_use ) && Pool_Alloc( &pool ) == NULL;
+
+    if( !ok )
+        printf( "Pool: allocation, exhaustion, double free or block size handling incorrect.\n" );
+    return ok;
+}
+
+// Spans: for every start position and count, writing through write_span/commit and reading back through
+// read_span/consume across the wrap point must give the same elements as get, and never exceed the free space
+static bool check_spans( void )
+{
+    bool ok = true;
+
+    for( int start = 0; start < RB_LENGTH_B; start++ ) {
+        for( int count = 0; count < RB_LENGTH_B + 2; count++ ) {
+            Ring_Buffer_Byte_t ring;
+            rb_initialize_B( &ring );
+            ring.start_index = ring.end_index = start;
+
+            // write in at most two spans; the second is empty once the ring is full
+            int written = 0;
+            for( int pass = 0; pass < 2; pass++ ) {
+                uint8_t* p_dst;
+                uint8_t space = rb_write_span_B( &ring, &p_dst );
+                uint8_t n     = ( count - written < space ) ? count - written : space;
+                for( uint8_t i = 0; i < n; i++ )
+                    p_dst[i] = (uint8_t)( written + i + 1 );
+                rb_commit_B( &ring, n );
+                written += n;
+            }
+            ok &= written == ( ( count < RB_LENGTH_B - 1 ) ? count : RB_LENGTH_B - 1 ) && rb_length_B( &ring ) == written;
+            for( int i = 0; i < written; i++ )
+                ok &= rb_get_B( &ring, i ) == i + 1;
+
+            int read = 0;
+            for( int pass = 0; pass < 2; pass++ ) {
+                const uint8_t* p_src;
+                uint8_t avail = rb_read_span_B( &ring, &p_src );
+                for( uint8_t i = 0; i < avail; i++ )
+                    ok &= p_src[i] == read + i + 1;
+                rb_consume_B( &ring, avail );
+                read += avail;
+            }
+            ok &= read == written && rb_length_B( &ring ) == 0;
+        }
+    }
+
+    for( int start = 0; start < RB_LENGTH_F; start++ ) {
+        Ring_Buffer_Float_t ring;
+        rb_initialize_F( &ring );
+        ring.start_index = ring.end_index = start;
+
+        float* p_dst;
+        for( int pass = 0, written = 0; pass < 2; pass++ ) {
+            uint8_t space = rb_write_span_F( &ring, &p_dst );
+            for( uint8_t i = 0; i < space; i++ )
+                p_dst[i] = written + i + 0.5f;
+            rb_commit_F( &ring, space );
+            written += space;
+        }
+        ok &= rb_length_F( &ring ) == RB_LENGTH_F - 1 && rb_write_span_F( &ring, &p_dst ) == 0;
+
+        const float* p_src;
+        for( int pass = 0, read = 0; pass < 2; pass++ ) {
+            uint8_t avail = rb_read_span_F( &ring, &p_src );
+            for( uint8_t i = 0; i < avail; i++ )
+                ok &= p_src[i] == read + i + 0.5f;
+            rb_consume_F( &ring, avail );
+            read += avail;
+        }
+        ok &= rb_length_F( &ring ) == 0;
+    }
+
+    if( !ok )
+        printf( "Spans: read_span/consume or write_span/commit incorrect across the wrap point.\n" );
+    return ok;
+}
+
+// File descriptors: bytes from a pipe must arrive in order across the wrap point, a full ring must report ENOBUFS
+// rather than 0, and only a closed pipe may return 0
+static bool check_fd( void )
+{
+    int fds[2];
+    uint8_t data[RB_LENGTH_B];
+    Ring_Buffer_Byte_t ring;
+    bool ok = pipe( fds ) == 0;
+
+    rb_initialize_B( &ring );
+    ring.start_index = ring.end_index = RB_LENGTH_B - 3;
+    for( int i = 0; i < RB_LENGTH_B; i++ )
+        data[i] = (uint8_t)( i * 7 );
+    ok &= write( fds[1], data, RB_LENGTH_B ) == RB_LENGTH_B;
+
+    ok &= rb_read_fd_B( &ring, fds[0] ) == RB_LENGTH_B - 1;
+    for( int i = 0; i < RB_LENGTH_B - 1; i++ )
+        ok &= rb_get_B( &ring, i ) == data[i];
+    errno = 0;
+    ok &= rb_read_fd_B( &ring, fds[0] ) == -1 && errno == ENOBUFS;
+
+    rb_pop_front_B( &ring );
+    close( fds[1] );
+    ok &= rb_read_fd_B( &ring, fds[0] ) == 1 && rb_get_B( &ring, RB_LENGTH_B - 2 ) == data[RB_LENGTH_B - 1];
+    rb_pop_front_B( &ring );
+    ok &= rb_read_fd_B( &ring, fds[0] ) == 0;
+    close( fds[0] );
+
+    if( !ok )
+        printf( "File descriptors: rb_read_fd_B lost bytes, or reported a full ring as end of file.\n" );
+    return ok;
+}
+
+// Search: 2M random operations on a byte ring, each followed by a byte and a sequence search that must agree with a
+// scan through rb_get_B. A small alphabet keeps partial matches, and matches across the wrap point, common.
+#define FIND_OPS 2000000
+
+static bool check_find( void )
+{
+    Ring_Buffer_Byte_t ring;
+    uint8_t pattern[4] = { 0 };
+    bool ok            = true;
+
+    rb_initialize_B( &ring );
+    for( uint32_t op = 0; op < FIND_OPS && ok; op++ ) {
+        uint32_t roll = check_random();
+        switch( roll % 5 ) {
+            case 0:
+            case 1: rb_push_back_B( &ring, ( roll >> 8 ) % 3 ); break;
+            case 2: rb_push_front_B( &ring, ( roll >> 8 ) % 3 ); break;
+            case 3: rb_pop_front_B( &ring ); break;
+            default: rb_consume_B( &ring, ( roll >> 8 ) % 4 ); break;
+        }
+
+        uint8_t length = ( roll >> 12 ) % 5;
+        for( uint8_t i = 0; i < length; i++ )
+            pattern[i] = ( roll >> ( 16 + 2 * i ) ) % 3;
+
+        // scanning backwards leaves the first index where the byte, and the whole pattern, match
+        uint8_t active  = rb_length_B( &ring );
+        int16_t byte_at = -1, seq_at = -1;
+        for( int16_t index = active - 1; index >= 0; index-- ) {
+            uint8_t matched = 0;
+            while( matched < length && index + matched < active && rb_get_B( &ring, index + matched ) == pattern[matched] )
+                matched++;
+            if( matched == length )
+                seq_at = index;
+            if( rb_get_B( &ring, index ) == pattern[0] )
+                byte_at = index;
+        }
+
+        ok &= rb_find_seq_B( &ring, pattern, length ) == seq_at && ( length == 0 || rb_find_B( &ring, pattern[0] ) == byte_at );
+    }
+
+    if( !ok )
+        printf( "Search: rb_find_B or rb_find_seq_B disagreed with a scan through rb_get_B.\n" );
+    return ok;
+}
+
+// Broadcast: three reader threads must each see the producer's sequence in order, all of it when blocking and with
+// every gap accounted for in missed when overwriting. Eight threads registering at once must get distinct slots.
+#define BCAST_COUNT 200000
+
+static Ring_Buffer_Broadcast_Float_t bcast;
+
+static void* bcast_reader( void* p_arg )
+{
+    int reader     = (int)(intptr_t)p_arg;
+    float next     = 0;  // value expected next, after any missed elements
+    uint64_t seen  = 0;
+    uint64_t wrong = 0;
+    float data[64];
+
+    while( next < BCAST_COUNT ) {
+        uint64_t missed_before = rb_bcast_missed_F( &bcast, reader );
+        uint32_t count         = rb_bcast_read_F( &bcast, reader, data, 64 );
+        if( count == 0 ) {
+            sched_yield();
+            continue;
+        }
+
+        next += rb_bcast_missed_F( &bcast, reader ) - missed_before;
+        for( uint32_t i = 0; i < count; i++ )
+            wrong += data[i] != next++;
+        seen += count;
+    }
+
+    return (void*)(intptr_t)( wrong == 0 && seen + rb_bcast_missed_F( &bcast, reader ) == BCAST_COUNT );
+}
+
+static void* bcast_adder( void* p_arg )
+{
+    (void)p_arg;
+    return (void*)(intptr_t)rb_bcast_add_reader_F( &bcast );
+}
+
+static bool check_broadcast( void )
+{
+    bool ok = true;
+
+    for( Rb_Bcast_Policy_t policy = RB_BCAST_BLOCK; policy <= RB_BCAST_OVERWRITE; policy++ ) {
+        pthread_t threads[3];
+        int readers[3];
+
+        rb_bcast_initialize_F( &bcast, policy );
+        for( int r = 0; r < 3; r++ ) {
+            readers[r] = rb_bcast_add_reader_F( &bcast );
+            pthread_create( &threads[r], NULL, bcast_reader, (void*)(intptr_t)readers[r] );
+        }
+
+        for( uint32_t i = 0; i < BCAST_COUNT; ) {
+            if( rb_bcast_push_back_F( &bcast, (float)i ) )
+                i++;
+            else
+                sched_yield();
+        }
+
+        for( int r = 0; r < 3; r++ ) {
+            void* p_result;
+            pthread_join( threads[r], &p_result );
+            ok &= p_result != NULL;
+            if( policy == RB_BCAST_BLOCK )
+                ok &= rb_bcast_missed_F( &bcast, readers[r] ) == 0;
+        }
+    }
+
+    pthread_t adders[RB_BCAST_MAX_READERS + 2];
+    int slots_used = 0;
+    int failed     = 0;
+    rb_bcast_initialize_F( &bcast, RB_BCAST_BLOCK );
+    for( int i = 0; i < RB_BCAST_MAX_READERS + 2; i++ )
+        pthread_create( &adders[i], NULL, bcast_adder, NULL );
+    for( int i = 0; i < RB_BCAST_MAX_READERS + 2; i++ ) {
+        void* p_result;
+        pthread_join( adders[i], &p_result );
+        int reader = (int)(intptr_t)p_result;
+        if( reader < 0 )
+            failed++;
+        else
+            slots_used |= 1 << reader;
+    }
+    ok &= failed == 2 && slots_used == ( 1 << RB_BCAST_MAX_READERS ) - 1;
+
+    if( !ok )
+        printf( "Broadcast: readers saw elements out of order, missed elements in blocking mode, or shared a slot.\n" );
+    return ok;
+}
+
+// MPSC: eight producer threads push producer * MPSC_STRIDE + i through the shared ring and through the sharded lanes;
+// the consumer must receive every element, in order per producer
+#define MPSC_PRODUCERS 8
+#define MPSC_COUNT     50000
+#define MPSC_STRIDE    100000
+
+static Ring_Buffer_MPSC_Float_t mpsc;
+static Ring_Buffer_Sharded_Float_t sharded;
+
+static void* mpsc_producer( void* p_arg )
+{
+    int producer = (int)(intptr_t)p_arg;
+    int lane     = rb_sharded_add_lane_F( &sharded );
+    float block[3];
+
+    // the shared ring alternates single pushes and three element writes, the lanes take single pushes
+    for( uint32_t i = 0; i < MPSC_COUNT; ) {
+        uint32_t n = ( i % 2 == 0 && MPSC_COUNT - i >= 3 ) ? 3 : 1;
+        for( uint32_t k = 0; k < n; k++ )
+            block[k] = (float)( producer * MPSC_STRIDE + i + k );
+        uint32_t written = ( n == 1 ) ? rb_mpsc_push_back_F( &mpsc, block[0] ) : rb_mpsc_write_F( &mpsc, block, n );
+        i += written;
+        if( written == 0 )
+            sched_yield();
+    }
+    for( uint32_t i = 0; i < MPSC_COUNT; ) {
+        if( rb_sharded_push_back_F( &sharded, lane, (float)( producer * MPSC_STRIDE + i ) ) )
+            i++;
+        else
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+// drains one queue until every element arrived, returning the number of out of order elements
+static uint32_t mpsc_consume( bool use_sharded )
+{
+    uint32_t next[MPSC_PRODUCERS] = { 0 };
+    uint32_t received             = 0;
+    uint32_t wrong                = 0;
+    float data[64];
+
+    while( received < MPSC_PRODUCERS * MPSC_COUNT ) {
+        uint32_t count = use_sharded ? rb_sharded_read_F( &sharded, data, 64 ) : rb_mpsc_read_F( &mpsc, data, 64 );
+        if( count == 0 )
+            sched_yield();
+        for( uint32_t i = 0; i < count; i++ ) {
+            uint32_t value    = (uint32_t)data[i];
+            uint32_t producer = value / MPSC_STRIDE;
+            if( producer >= MPSC_PRODUCERS || value % MPSC_STRIDE != next[producer] )
+                wrong++;
+            else
+                next[producer]++;
+        }
+        received += count;
+    }
+
+    return wrong;
+}
+
+static bool check_mpsc( void )
+{
+    pthread_t producers[MPSC_PRODUCERS];
+
+    rb_mpsc_initialize_F( &mpsc );
+    rb_sharded_initialize_F( &sharded );
+    for( int p = 0; p < MPSC_PRODUCERS; p++ )
+        pthread_create( &producers[p], NULL, mpsc_producer, (void*)(intptr_t)p );
+
+    uint32_t wrong = mpsc_consume( false );
+    wrong += mpsc_consume( true );
+    for( int p = 0; p < MPSC_PRODUCERS; p++ )
+        pthread_join( producers[p], NULL );
+
+    bool ok = wrong == 0 && rb_mpsc_length_F( &mpsc ) == 0;
+    if( !ok )
+        printf( "MPSC: %u elements out of order per producer.\n", wrong );
+    return ok;
+}
+
+// Wait: a producer thread streams a byte sequence through a waiter while the consumer sleeps on a watermark; the
+// consumer must see the sequence in order. A count larger than the ring is clamped and satisfied by a full ring.
+#define WAIT_COUNT 200000
+
+static Ring_Buffer_SPSC_Byte_t wait_ring;
+static Rb_Wait_t waiter;
+
+static void* wait_producer( void* p_arg )
+{
+    (void)p_arg;
+    for( uint32_t i = 0; i < WAIT_COUNT; ) {
+        if( rb_wait_push_back_B( &waiter, (uint8_t)i ) )
+            i++;
+        else
+            sched_yield();
+    }
+    rb_wait_wake( &waiter );
+    return NULL;
+}
+
+static bool check_wait( void )
+{
+    pthread_t producer;
+    Rb_Wait_Stats_t stats;
+    uint32_t received = 0;
+    uint32_t wrong    = 0;
+    uint8_t data[64];
+
+    rb_spsc_initialize_B( &wait_ring );
+    rb_wait_initialize_B( &waiter, &wait_ring );
+    pthread_create( &producer, NULL, wait_producer, NULL );
+    while( received < WAIT_COUNT ) {
+        uint32_t want = ( WAIT_COUNT - received < 64 ) ? WAIT_COUNT - received : 64;
+        rb_wait_for( &waiter, want, 100 );
+        uint32_t count = rb_spsc_read_B( &wait_ring, data, want );
+        for( uint32_t i = 0; i < count; i++ )
+            wrong += data[i] != (uint8_t)received++;
+    }
+    pthread_join( producer, NULL );
+    rb_wait_get_stats( &waiter, &stats );
+    bool ok = wrong == 0 && stats.notifies == WAIT_COUNT;
+
+    rb_spsc_initialize_B( &wait_ring );
+    rb_wait_initialize_B( &waiter, &wait_ring );
+    for( uint32_t i = 0; i < RB_LENGTH_SPSC; i++ )
+        ok &= rb_wait_push_back_B( &waiter, (uint8_t)i );
+    ok &= !rb_wait_push_back_B( &waiter, 0 );
+    ok &= rb_wait_for( &waiter, RB_LENGTH_SPSC + 1, 1000 ) == RB_LENGTH_SPSC;
+    rb_wait_get_stats( &waiter, &stats );
+    ok &= stats.timeouts == 0 && stats.sleeps == 0;
+
+    if( !ok )
+        printf( "Wait: %u bytes out of order, or a count above the ring length was not clamped.\n", wrong );
+    return ok;
+}
+
+// Event: the eventfd must become readable exactly when the threshold is reached, stay signalled across an ack while
+// the ring is still above it, and clear once drained. A producer thread then streams a byte sequence that the
+// consumer drains from a poll loop, in order.
+#define EVENT_COUNT     200000
+#define EVENT_THRESHOLD 32
+
+static Ring_Buffer_SPSC_Byte_t event_ring;
+static Rb_Event_t event;
+
+static bool event_readable( int timeout_ms )
+{
+    struct pollfd pfd = { .fd = event.fd, .events = POLLIN };
+    return poll( &pfd, 1, timeout_ms ) == 1 && ( pfd.revents & POLLIN );
+}
+
+static void* event_producer( void* p_arg )
+{
+    (void)p_arg;
+    for( uint32_t i = 0; i < EVENT_COUNT; ) {
+        if( rb_event_push_back_B( &event, (uint8_t)i ) )
+            i++;
+        else
+            sched_yield();
+    }
+    return NULL;
+}
+
+static bool check_event( void )
+{
+    pthread_t producer;
+    uint32_t received = 0;
+    uint32_t wrong    = 0;
+    uint8_t data[64];
+    bool ok = true;
+
+    rb_spsc_initialize_B( &event_ring );
+    ok &= rb_event_initialize_B( &event, &event_ring, EVENT_THRESHOLD ) >= 0;
+    for( uint32_t i = 0; i + 1 < EVENT_THRESHOLD; i++ )
+        rb_event_push_back_B( &event, (uint8_t)i );
+    ok &= !event_readable( 0 );
+    rb_event_push_back_B( &event, 0 );
+    ok &= event_readable( 0 );
+    ok &= rb_event_ack( &event ) == EVENT_THRESHOLD && event_readable( 0 );
+    ok &= rb_spsc_read_B( &event_ring, data, 64 ) == EVENT_THRESHOLD;
+    ok &= rb_event_ack( &event ) == 0 && !event_readable( 0 );
+    ok &= atomic_load( &event.signals ) == 2;
+
+    pthread_create( &producer, NULL, event_producer, NULL );
+    while( received < EVENT_COUNT ) {
+        // the tail below the threshold never signals, so the timeout picks it up
+        event_readable( 10 );
+        uint32_t count;
+        while( ( count = rb_spsc_read_B( &event_ring, data, 64 ) ) > 0 )
+            for( uint32_t i = 0; i < count; i++ )
+                wrong += data[i] != (uint8_t)received++;
+        rb_event_ack( &event );
+    }
+    pthread_join( producer, NULL );
+    ok &= wrong == 0;
+    rb_event_close( &event );
+
+    if( !ok )
+        printf( "Event: descriptor signalled at the wrong time, or %u bytes out of order.\n", wrong );
+    return ok;
+}
+
+// Shm: data must survive the wrap point of a shared segment, and rb_shm_open_F must refuse a header whose capacity
+// or mask does not describe the mapping
+static bool check_shm( void )
+{
+    char name[32];
+    float data[48];
+    bool ok = true;
+
+    snprintf( name, sizeof( name ), "/rb_check_%d", (int)getpid() );
+    Ring_Buffer_Shm_Float_t* p_prod = rb_shm_create_F( name, 64 );
+    Ring_Buffer_Shm_Float_t* p_cons = rb_shm_open_F( name );
+    if( p_prod == NULL || p_cons == NULL ) {
+        printf( "Shm: could not create or open the segment.\n" );
+        rb_shm_unlink_F( name );
+        return false;
+    }
+
+    for( int round = 0; round < 4; round++ ) {
+        for( int i = 0; i < 48; i++ )
+            data[i] = (float)( round * 48 + i );
+        ok &= rb_shm_write_F( p_prod, data, 48 ) == 48;
+        ok &= rb_shm_read_F( p_cons, data, 48 ) == 48;
+        for( int i = 0; i < 48; i++ )
+            ok &= data[i] == (float)( round * 48 + i );
+    }
+
+    p_prod->mask = 31;
+    ok &= rb_shm_open_F( name ) == NULL;
+    p_prod->mask     = 63;
+    p_prod->capacity = 48;
+    ok &= rb_shm_open_F( name ) == NULL;
+    p_prod->capacity = 128;
+    p_prod->mask     = 127;
+    ok &= rb_shm_open_F( name ) == NULL;
+    p_prod->capacity = 64;
+    p_prod->mask     = 63;
+
+    rb_shm_close_F( p_cons );
+    rb_shm_close_F( p_prod );
+    rb_shm_unlink_F( name );
+
+    if( !ok )
+        printf( "Shm: data lost across the wrap point, or a corrupt header was accepted.\n" );
+    return ok;
+}
+
+// Mirror: 2M random operations on a byte mirror ring against a plain deque model, in phases that alternately fill
+// and drain so the full and empty edge cases are hit many times. Capacities above 2^31 must be refused.
+#define MIRROR_OPS   2000000
+#define MIRROR_MODEL 16384  // model storage, larger than the ring so its wrap point differs
+
+static bool check_mirror( void )
+{
+    static uint8_t model[MIRROR_MODEL];
+    Ring_Buffer_Mirror_Byte_t ring;
+    uint32_t head = 0, length = 0;  // model: element i lives at model[( head + i ) % MIRROR_MODEL]
+    uint32_t bad_op = 0;
+
+    if( !rb_mirror_initialize_B( &ring, 1024 ) ) {
+        printf( "Mirror: could not map the ring.\n" );
+        return false;
+    }
+    uint32_t max = ring.capacity - 1;
+
+    for( uint32_t op = 0; op < MIRROR_OPS && bad_op == 0; op++ ) {
+        bool filling    = ( op / ( 4 * ring.capacity ) ) % 2 == 0;
+        uint32_t roll   = check_random();
+        uint32_t action = roll % 10;
+        uint8_t value   = (uint8_t)( roll >> 24 );
+        bool ok         = true;
+
+        // while draining, half of the push_backs become pop_fronts
+        if( !filling && action < 3 && roll % 2 )
+            action = 4;
+
+        switch( action ) {
+            case 0:
+            case 1:
+            case 2:
+                rb_mirror_push_back_B( &ring, value );
+                if( length == max ) {
+                    head = ( head + 1 ) % MIRROR_MODEL;
+                    length--;
+                }
+                model[( head + length++ ) % MIRROR_MODEL] = value;
+                break;
+            case 3:
+                rb_mirror_push_front_B( &ring, value );
+                if( length == max )
+                    length--;
+                head        = ( head + MIRROR_MODEL - 1 ) % MIRROR_MODEL;
+                model[head] = value;
+                length++;
+                break;
+            case 4:
+                ok   = rb_mirror_pop_front_B( &ring ) == ( length ? model[head] : 0 );
+                head = length ? ( head + 1 ) % MIRROR_MODEL : head;
+                length -= length ? 1 : 0;
+                break;
+            case 5:
+                ok = rb_mirror_pop_back_B( &ring ) == ( length ? model[( head + length - 1 ) % MIRROR_MODEL] : 0 );
+                length -= length ? 1 : 0;
+                break;
+            case 6:
+                if( length ) {
+                    uint32_t index = roll % length;
+                    ok             = rb_mirror_get_B( &ring, index ) == model[( head + index ) % MIRROR_MODEL];
+                    rb_mirror_set_B( &ring, index, value );
+                    model[( head + index ) % MIRROR_MODEL] = value;
+                }
+                break;
+            case 7: {
+                uint32_t count = roll % 64;
+                rb_mirror_consume_B( &ring, count );
+                count = ( count < length ) ? count : length;
+                head  = ( head + count ) % MIRROR_MODEL;
+                length -= count;
+                break;
+            }
+            case 8: {
+                uint32_t room;
+                uint8_t* p_free = rb_mirror_write_view_B( &ring, &room );
+                uint32_t count  = roll % 64;
+                ok              = room == max - length;
+                count           = ( count < room ) ? count : room;
+                for( uint32_t i = 0; i < count; i++ )
+                    p_free[i] = model[( head + length++ ) % MIRROR_MODEL] = (uint8_t)( value + i );
+                rb_mirror_commit_B( &ring, count );
+                break;
+            }
+            default: {
+                // the whole view only occasionally, it is O(length)
+                uint32_t view_length;
+                const uint8_t* p_view = rb_mirror_view_B( &ring, &view_length );
+                ok                    = view_length == length;
+                if( roll % 64 == 9 )
+                    for( uint32_t i = 0; ok && i < length; i++ )
+                        ok = p_view[i] == model[( head + i ) % MIRROR_MODEL];
+                break;
+            }
+        }
+
+        if( !ok || rb_mirror_length_B( &ring ) != length )
+            bad_op = op + 1;
+    }
+    rb_mirror_free_B( &ring );
+
+    Ring_Buffer_Mirror_Byte_t huge;
+    bool refused = !rb_mirror_initialize_B( &huge, ( UINT32_C( 1 ) << 31 ) + 1 ) && huge.buffer == NULL;
+
+    if( bad_op != 0 || !refused )
+        printf( "Mirror: diverged from the model at operation %u, or a capacity above 2^31 was accepted.\n", bad_op );
+    return bad_op == 0 && refused;
+}
+
+// Ingest: with each backend, nonblocking pipes drained a few bytes at a time so their rings keep filling up must
+// deliver every byte in order and close only at end of file, and an idle nonblocking pipe must make rb_ingest_poll
+// sleep for its timeout rather than return at once
+#define INGEST_SOURCES 3
+#define INGEST_COUNT   20000
+#define INGEST_CHUNK   100
+
+static int ingest_pipes[INGEST_SOURCES][2];
+
+static void* ingest_writer( void* p_arg )
+{
+    (void)p_arg;
+    uint8_t chunk[INGEST_CHUNK];
+
+    for( uint32_t sent = 0; sent < INGEST_COUNT; sent += INGEST_CHUNK ) {
+        for( int s = 0; s < INGEST_SOURCES; s++ ) {
+            for( uint32_t i = 0; i < INGEST_CHUNK; i++ )
+                chunk[i] = (uint8_t)( s * 31 + sent + i );
+            // blocking write end, so a full pipe just waits for the reader
+            (void)!write( ingest_pipes[s][1], chunk, INGEST_CHUNK );
+        }
+    }
+
+    for( int s = 0; s < INGEST_SOURCES; s++ )
+        close( ingest_pipes[s][1] );
+    return NULL;
+}
+
+static double ingest_now( void )
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static bool ingest_stream( bool allow_uring )
+{
+    Ring_Buffer_Byte_t rings[INGEST_SOURCES];
+    uint32_t received[INGEST_SOURCES] = { 0 };
+    uint32_t wrong                    = 0;
+    Rb_Ingest_t ingest;
+    pthread_t writer;
+    bool ok = rb_ingest_initialize( &ingest, allow_uring );
+
+    for( int s = 0; ok && s < INGEST_SOURCES; s++ ) {
+        ok &= pipe( ingest_pipes[s] ) == 0;
+        fcntl( ingest_pipes[s][0], F_SETFL, O_NONBLOCK );
+        rb_initialize_B( &rings[s] );
+        ok &= rb_ingest_add( &ingest, ingest_pipes[s][0], &rings[s] ) == s;
+    }
+    if( !ok )
+        return false;
+
+    pthread_create( &writer, NULL, ingest_writer, NULL );
+    double give_up = ingest_now() + 20.0;
+    for( int open_sources = INGEST_SOURCES; ok && open_sources > 0; ) {
+        ok &= rb_ingest_poll( &ingest, 20 ) >= 0 && ingest_now() < give_up;
+
+        open_sources = 0;
+        for( int s = 0; s < INGEST_SOURCES; s++ ) {
+            // take only a few bytes so the rings are often full when the next poll comes
+            for( int i = 0; i < 5 && rb_length_B( &rings[s] ) > 0; i++ )
+                wrong += rb_pop_front_B( &rings[s] ) != (uint8_t)( s * 31 + received[s]++ );
+            if( !ingest.sources[s].closed )
+                open_sources++;
+            else
+                while( rb_length_B( &rings[s] ) > 0 )
+                    wrong += rb_pop_front_B( &rings[s] ) != (uint8_t)( s * 31 + received[s]++ );
+        }
+    }
+    pthread_join( writer, NULL );
+
+    for( int s = 0; s < INGEST_SOURCES; s++ ) {
+        ok &= received[s] == INGEST_COUNT && ingest.sources[s].error == 0;
+        close( ingest_pipes[s][0] );
+    }
+    rb_ingest_close( &ingest );
+    return ok && wrong == 0;
+}
+
+static bool ingest_idle( bool allow_uring )
+{
+    Ring_Buffer_Byte_t rings[2];
+    Rb_Ingest_t ingest;
+    int idle[2], hung_up[2];
+
+    if( !rb_ingest_initialize( &ingest, allow_uring ) || pipe( idle ) != 0 || pipe( hung_up ) != 0 )
+        return false;
+    fcntl( idle[0], F_SETFL, O_NONBLOCK );
+    fcntl( hung_up[0], F_SETFL, O_NONBLOCK );
+    close( hung_up[1] );
+    rb_initialize_B( &rings[0] );
+    rb_initialize_B( &rings[1] );
+    bool ok = rb_ingest_add( &ingest, idle[0], &rings[0] ) == 0 && rb_ingest_add( &ingest, hung_up[0], &rings[1] ) == 1;
+
+    // let the hung up pipe reach end of file, and an io_uring read of the idle pipe come back with EAGAIN if it does
+    for( int i = 0; i < 4 && !ingest.sources[1].closed; i++ )
+        rb_ingest_poll( &ingest, 20 );
+    ok &= ingest.sources[1].closed && ingest.sources[1].error == 0;
+
+    // from here on neither the hang up nor the nonblocking descriptor may cut the wait short. A poll can still return
+    // early on EINTR, so allow a few more calls than the three timeouts 60 ms should take, but not a busy loop.
+    int polls    = 0;
+    double start = ingest_now();
+    while( ingest_now() - start < 0.06 && polls++ < 10 )
+        ok &= rb_ingest_poll( &ingest, 20 ) == 0;
+    ok &= polls <= 6 && !ingest.sources[0].closed;
+
+    rb_ingest_close( &ingest );
+    close( idle[0] );
+    close( idle[1] );
+    close( hung_up[0] );
+    return ok;
+}
+
+static bool check_ingest( void )
+{
+    bool ok = true;
+    for( int allow_uring = 1; allow_uring >= 0; allow_uring-- )
+        ok &= ingest_stream( allow_uring ) && ingest_idle( allow_uring );
+
+    if( !ok )
+        printf( "Ingest: bytes lost or out of order, a source closed before end of file, or a poll ignored its timeout.\n" );
+    return ok;
+}
+
+// Recorder: a write cut short after claiming its slots must hide the oldest samples it may have hit, also after the
+// recorder is reopened, and opening an existing recording with another capacity must fail and leave it untouched
+static bool check_recorder( void )
+{
+    Ring_Buffer_Recorder_Float_t rec, reader;
+    float data[100];
+    char path[64];
+    bool ok = true;
+
+    snprintf( path, sizeof( path ), "/tmp/rb_check_%d.rec", (int)getpid() );
+    unlink( path );
+    if( !rb_recorder_open_F( &rec, path, 64, 0 ) ) {
+        printf( "Recorder: could not create %s.\n", path );
+        return false;
+    }
+
+    for( int i = 0; i < 100; i++ )
+        data[i] = (float)i;
+    rb_recorder_write_F( &rec, data, 100 );
+    for( int i = 100; i < 110; i++ )
+        rb_recorder_push_back_F( &rec, (float)i );
+    ok &= rb_recorder_length_F( &rec ) == 64 && rb_recorder_get_F( &rec, 0 ) == 46.0f;
+
+    // what a crash part way through writing 10 samples leaves behind: the claim and some of the samples
+    atomic_store( &rec.p_header->claimed, atomic_load( &rec.p_header->sequence ) + 10 );
+    for( uint32_t i = 0; i < 4; i++ )
+        rec.buffer[( 110 + i ) & 63] = -1.0f;
+    rb_recorder_close_F( &rec );
+
+    ok &= !rb_recorder_open_F( &rec, path, 128, 0 );
+    ok &= rb_recorder_attach_F( &reader, path );
+    if( ok ) {
+        ok &= rb_recorder_length_F( &reader ) == 54 && rb_recorder_copy_F( &reader, data, 100 ) == 54;
+        for( int i = 0; i < 54; i++ )
+            ok &= data[i] == (float)( 56 + i );
+        rb_recorder_close_F( &reader );
+    }
+
+    // resuming must keep the hidden samples hidden until the writer has moved past them
+    ok &= rb_recorder_open_F( &rec, path, 64, 0 ) && rec.p_header->generation == 1;
+    if( ok ) {
+        rb_recorder_push_back_F( &rec, 110.0f );
+        ok &= rb_recorder_length_F( &rec ) == 55 && rb_recorder_get_F( &rec, 0 ) == 56.0f;
+        for( int i = 111; i < 120; i++ )
+            rb_recorder_push_back_F( &rec, (float)i );
+        ok &= rb_recorder_length_F( &rec ) == 64 && rb_recorder_get_F( &rec, 0 ) == 56.0f;
+        rb_recorder_close_F( &rec );
+    }
+    unlink( path );
+
+    if( !ok )
+        printf( "Recorder: overwritten samples were still reported, or a recording of another capacity was reopened.\n" );
+    return ok;
+}
+
+// Delta test signal: small steps, a jump every 97 samples that needs a 5 byte varint there and back, and values past
+// 2^24 steps every 89 samples
+static float delta_signal( uint32_t i )
+{
+    if( i % 97 == 0 )
+        return ( i & 1 ) ? 200000.3f : -200000.3f;
+    if( i % 89 == 0 )
+        return 16777.217f + ( i % 3 ) * 0.001f;
+    return ( i % 50 ) * 0.0137f - 0.3f;
+}
+
+// Delta: the signal must come back through wrapping rings to within resolution / 2, or one float step where that is
+// coarser, and a varint longer than 32 bits must stop the decoder and stay in the byte ring
+static bool check_delta( void )
+{
+    const float resolution = 0.001f;
+    Rb_Delta_t encoder, decoder;
+    Ring_Buffer_Float_t source, received;
+    Ring_Buffer_Byte_t link;
+    uint32_t sent = 0, checked = 0;
+    bool ok = true;
+
+    rb_delta_initialize( &encoder, resolution );
+    rb_delta_initialize( &decoder, resolution );
+    rb_initialize_F( &source );
+    rb_initialize_F( &received );
+    rb_initialize_B( &link );
+
+    for( int round = 0; round < 100000 && checked < 2000; round++ ) {
+        while( sent < 2000 && rb_length_F( &source ) < RB_LENGTH_F - 1 )
+            rb_push_back_F( &source, delta_signal( sent++ ) );
+        rb_delta_encode( &encoder, &source, &link );
+        rb_delta_decode( &decoder, &link, &received );
+
+        while( rb_length_F( &received ) > 0 ) {
+            float expected = delta_signal( checked++ );
+            float error    = rb_pop_front_F( &received ) - expected;
+            float limit    = resolution * 0.5001f + ( ( expected < 0 ) ? -expected : expected ) * 0x1p-23f;
+            ok &= error <= limit && -error <= limit;
+        }
+    }
+    ok &= checked == 2000 && encoder.bytes == decoder.bytes && !decoder.corrupt;
+
+    rb_delta_initialize( &decoder, resolution );
+    rb_initialize_B( &link );
+    for( int i = 0; i < 5; i++ )
+        rb_push_back_B( &link, 0xFF );
+    rb_push_back_B( &link, 0x01 );
+    ok &= rb_delta_decode( &decoder, &link, &received ) == 0 && decoder.corrupt && rb_length_B( &link ) == 6;
+    ok &= rb_delta_decode( &decoder, &link, &received ) == 0 && rb_length_F( &received ) == 0;
+
+    if( !ok )
+        printf( "Delta: decoded samples were off by more than half a step, or an overlong varint was decoded.\n" );
+    return ok;
+}
+
+// Framing: random payloads heavy in 0x00, END and ESC must survive COBS and SLIP as frames straddle the wrap point,
+// an empty SLIP frame must append nothing, and broken or oversized frames must be removed as RB_FRAME_INVALID
+static bool check_frame( void )
+{
+    static const uint8_t special[] = { 0x00, 0xC0, 0xDB, 0xDC, 0xDD, 0x01, 0xFF };
+    Ring_Buffer_Byte_t ring;
+    uint8_t data[RB_LENGTH_B], out[RB_LENGTH_B];
+    bool ok = true;
+
+    rb_initialize_B( &ring );
+    for( int round = 0; round < 2000 && ok; round++ ) {
+        bool cobs      = round & 1;
+        uint8_t length = check_random() % ( RB_LENGTH_B - 2 );
+        uint8_t fit    = length + 2;  // encoded size, which may not fit for SLIP
+        for( uint8_t i = 0; i < length; i++ ) {
+            uint32_t roll = check_random();
+            data[i]       = ( roll & 1 ) ? special[( roll >> 1 ) % sizeof( special )] : (uint8_t)( roll >> 8 );
+            fit += !cobs && ( data[i] == 0xC0 || data[i] == 0xDB );
+        }
+
+        uint8_t size = cobs ? rb_cobs_encode_B( &ring, data, length ) : rb_slip_encode_B( &ring, data, length );
+        if( size == 0 ) {
+            ok &= !cobs && ( length == 0 || fit > RB_LENGTH_B - 1 ) && rb_length_B( &ring ) == 0;
+            continue;
+        }
+        ok &= size == fit && rb_length_B( &ring ) == size;
+
+        // the frame arrives whole, so nothing is left once it is decoded
+        int16_t got = cobs ? rb_cobs_decode_B( &ring, out, sizeof( out ) ) : rb_slip_decode_B( &ring, out, sizeof( out ) );
+        ok &= got == length && memcmp( out, data, length ) == 0 && rb_length_B( &ring ) == 0;
+    }
+
+    // a partial frame stays, less the END before it that opens an empty frame, and one too long for the buffer is dropped
+    rb_slip_encode_B( &ring, (const uint8_t*)"abcdef", 6 );
+    rb_pop_back_B( &ring );
+    ok &= rb_slip_decode_B( &ring, out, sizeof( out ) ) == RB_FRAME_INCOMPLETE && rb_length_B( &ring ) == 6;
+    rb_push_back_B( &ring, 0xC0 );
+    ok &= rb_slip_decode_B( &ring, out, 4 ) == RB_FRAME_INVALID && rb_length_B( &ring ) == 0;
+
+    // a COBS code running past the frame, an ESC followed by neither 0xDC nor 0xDD, and a full ring with no delimiter
+    const uint8_t bad_cobs[] = { 0x05, 0x11, 0x22, 0x00 }, bad_slip[] = { 0xC0, 0x11, 0xDB, 0x22, 0xC0 };
+    for( uint8_t i = 0; i < sizeof( bad_cobs ); i++ )
+        rb_push_back_B( &ring, bad_cobs[i] );
+    ok &= rb_cobs_decode_B( &ring, out, sizeof( out ) ) == RB_FRAME_INVALID && rb_length_B( &ring ) == 0;
+    for( uint8_t i = 0; i < sizeof( bad_slip ); i++ )
+        rb_push_back_B( &ring, bad_slip[i] );
+    ok &= rb_slip_decode_B( &ring, out, sizeof( out ) ) == RB_FRAME_INVALID && rb_length_B( &ring ) == 0;
+    for( int i = 0; i < RB_LENGTH_B - 1; i++ )
+        rb_push_back_B( &ring, 0x11 );
+    ok &= rb_cobs_decode_B( &ring, out, sizeof( out ) ) == RB_FRAME_INVALID && rb_length_B( &ring ) == 0;
+
+    if( !ok )
+        printf( "Framing: a COBS or SLIP frame did not survive the ring, or a broken frame was not dropped.\n" );
+    return ok;
+}
+
+// CRC: "123456789" pushed into a ring across its wrap point must give the standard check values both incrementally
+// and over the ring range, and a push into a full ring must be refused without touching the ring or the CRC
+static bool check_crc( void )
+{
+    static const uint32_t check_values[] = { 0x4B37, 0xCBF43926, 0xE3069283 };
+    const uint8_t* p_text                = (const uint8_t*)"123456789";
+    Ring_Buffer_Byte_t ring;
+    Rb_Crc_t crc;
+    bool ok = true;
+
+    for( Rb_Crc_Kind_t kind = RB_CRC16_MODBUS; kind <= RB_CRC32C; kind++ ) {
+        ring.start_index = ring.end_index = RB_LENGTH_B - 4;
+        rb_crc_initialize( &crc, kind );
+        for( int i = 0; i < 9; i++ )
+            ok &= rb_crc_push_back_B( &crc, &ring, p_text[i] );
+
+        uint32_t range = ( kind == RB_CRC16_MODBUS ) ? rb_crc16_B( &ring, 0, 9 )
+                         : ( kind == RB_CRC32 )      ? rb_crc32_B( &ring, 0, 9 )
+                                                     : rb_crc32c_B( &ring, 0, 9 );
+        ok &= rb_crc_value( &crc ) == check_values[kind] && range == check_values[kind];
+
+        rb_crc_initialize( &crc, kind );
+        rb_crc_update( &crc, p_text, 9 );
+        ok &= rb_crc_value( &crc ) == check_values[kind];
+    }
+
+    while( rb_length_B( &ring ) < RB_LENGTH_B - 1 )
+        rb_push_back_B( &ring, 0x55 );
+    rb_crc_initialize( &crc, RB_CRC32 );
+    uint8_t first = rb_get_B( &ring, 0 );
+    ok &= !rb_crc_push_back_B( &crc, &ring, 0xAA ) && rb_crc_value( &crc ) == 0;
+    ok &= rb_length_B( &ring ) == RB_LENGTH_B - 1 && rb_get_B( &ring, 0 ) == first && rb_get_B( &ring, RB_LENGTH_B - 2 ) == 0x55;
+
+    if( !ok )
+        printf( "CRC: a check value was wrong, or a push into a full ring was accepted.\n" );
+    return ok;
+}
+
+static bool ( *const extension_checks[] )( void ) = { check_pool, check_spans, check_fd, check_find, check_broadcast, check_mpsc, check_wait, check_event,
+                                                      check_shm, check_mirror, check_ingest, check_recorder, check_delta,
+                                                      check_frame, check_crc };
 
 int main( void )
 {
@@ -363,5 +1376,11 @@ int main( void )
     else
         score++;
 
+    int checks_passed = 0;
+    int checks_total  = sizeof( extension_checks ) / sizeof( extension_checks[0] );
+    for( int i = 0; i < checks_total; i++ )
+        checks_passed += extension_checks[i]();
+    printf( "Extension checks: %i / %i passed\n", checks_passed, checks_total );
+
     printf( "Score: %2.1f out of 75\n", (float)score / 35.0 * 75 );
 }